@@ -3,6 +3,10 @@
 #include <vector>
 #include <utility>//for std::pair(store guess and pattern)
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <sstream>
 
 using namespace std;
 //judge
@@ -99,6 +103,194 @@ void solve_filter() {
     cout << consistent_count << endl;
 }
 
+// ---- BATCH mode: load the dictionary once, then answer many queries ----
+
+//dictionary prepared once: letters back to back and letter counts per word,
+//so checking a word against a round never builds strings or count vectors
+struct PreparedDictionary {
+    int L = 5;
+    vector<string> words;
+    vector<char> letters;//words.size() * L
+    vector<array<unsigned char, 26>> counts;//how many of each letter a word has
+
+    void build() {
+        letters.resize(words.size() * L);
+        counts.assign(words.size(), array<unsigned char, 26>{});
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (int i = 0; i < L; ++i) {
+                letters[w * L + i] = words[w][i];
+                counts[w][words[w][i] - 'a']++;
+            }
+        }
+    }
+};
+
+//one query from the input
+struct Query {
+    enum Kind { FEEDBACK, FILTER, LIST } kind;
+    vector<pair<string, string>> rounds;//FEEDBACK keeps (secret, guess) in rounds[0]
+    string error;//set for a bad line, which is answered with it instead
+};
+
+//same rules as generate_feedback, but only answers "would 'secret' give 'pattern' for 'guess'?"
+//and stops at the first letter that disagrees
+bool matches_round(const char* secret, const array<unsigned char, 26>& secret_counts,
+                   const string& guess, const string& pattern, int L) {
+    int counts[26];
+    for (int c = 0; c < 26; ++c) counts[c] = secret_counts[c];
+    //greens first, a green in the pattern must be an exact match and the other way round
+    for (int i = 0; i < L; ++i) {
+        bool green = (guess[i] == secret[i]);
+        if (green != (pattern[i] == 'G')) return false;
+        if (green) counts[guess[i] - 'a']--;
+    }
+    //then yellow or black, left to right like generate_feedback
+    for (int i = 0; i < L; ++i) {
+        if (pattern[i] == 'G') continue;
+        int char_index = guess[i] - 'a';
+        char expected = 'B';
+        if (counts[char_index] > 0) {
+            expected = 'Y';
+            counts[char_index]--;
+        }
+        if (pattern[i] != expected) return false;
+    }
+    return true;
+}
+
+//the answer line for one query (without the newline)
+string answer_query(const PreparedDictionary& dict, const Query& query) {
+    if (!query.error.empty()) return query.error;
+    if (query.kind == Query::FEEDBACK) {
+        return generate_feedback(query.rounds[0].first, query.rounds[0].second);
+    }
+    int consistent_count = 0;
+    string listed;
+    for (size_t w = 0; w < dict.words.size(); ++w) {
+        bool is_consistent = true;
+        for (const auto& round : query.rounds) {
+            if (!matches_round(&dict.letters[w * dict.L], dict.counts[w], round.first, round.second, dict.L)) {
+                is_consistent = false;
+                break;
+            }
+        }
+        if (is_consistent) {
+            consistent_count++;
+            if (query.kind == Query::LIST) {
+                listed += ' ';
+                listed += dict.words[w];
+            }
+        }
+    }
+    return to_string(consistent_count) + listed;
+}
+
+//L letters a-z, so it can index letter counts
+bool is_word(const string& w, int L) {
+    return (int)w.size() == L && all_of(w.begin(), w.end(), [](char c) { return c >= 'a' && c <= 'z'; });
+}
+//L letters G/Y/B
+bool is_pattern(const string& p, int L) {
+    return (int)p.size() == L && all_of(p.begin(), p.end(), [](char c) { return c == 'G' || c == 'Y' || c == 'B'; });
+}
+
+//the rest of a query line after its kind, false if it does not fit the format.
+//Every word and pattern is checked here, answering never sees a bad one
+bool parse_query(istringstream& in, const string& kind, int L, Query& query) {
+    if (kind == "FEEDBACK") {
+        query.kind = Query::FEEDBACK;
+        query.rounds.resize(1);
+        string extra;
+        return (in >> query.rounds[0].first >> query.rounds[0].second) && !(in >> extra) &&
+               is_word(query.rounds[0].first, L) && is_word(query.rounds[0].second, L);
+    }
+    if (kind == "FILTER") query.kind = Query::FILTER;
+    else if (kind == "LIST") query.kind = Query::LIST;
+    else return false;
+
+    int Q;
+    if (!(in >> Q) || Q < 0) return false;
+    pair<string, string> round;
+    for (int i = 0; i < Q; ++i) {//grows per round read, a huge Q on a short line just fails
+        if (!(in >> round.first >> round.second) || !is_word(round.first, L) || !is_pattern(round.second, L)) {
+            return false;
+        }
+        query.rounds.push_back(round);
+    }
+    string extra;
+    return !(in >> extra);
+}
+
+//reads one query line, false at end of input.
+//A bad line still counts as a query, its 'error' is set to the "ERROR ..." line to answer
+//  FEEDBACK <secret> <guess>
+//  FILTER <Q> <guess> <pattern> ... (Q rounds)   -> consistent_count
+//  LIST <Q> <guess> <pattern> ...                -> consistent_count and the words
+//One query per line, so a query is complete as soon as its line is.
+bool read_query(Query& query, int L) {
+    string line, kind;
+    istringstream in;
+    do {//blank lines are skipped
+        if (!getline(cin, line)) return false;
+        in.clear();
+        in.str(line);
+    } while (!(in >> kind));
+    query.rounds.clear();
+    query.error.clear();
+    if (!parse_query(in, kind, L, query)) query.error = "ERROR bad query: " + line;
+    return true;
+}
+
+//BATCH: dictionary once, then queries until end of input.
+//Queries are read in blocks, answered by all cores, and printed in input order.
+//A block ends at block_size queries or as soon as no more input is waiting, and is flushed
+//right away, so a client that sends one query over a pipe and waits gets its answer.
+void solve_batch() {
+    PreparedDictionary dict;
+    int N;
+    if (!(cin >> N)) return;
+    dict.words.resize(N);
+    for (int i = 0; i < N; ++i) {
+        if (!(cin >> dict.words[i])) return;
+    }
+    //only words of the right length can ever match, and counts need a-z letters
+    dict.words.erase(remove_if(dict.words.begin(), dict.words.end(),
+                               [&](const string& w) { return !is_word(w, dict.L); }),
+                     dict.words.end());
+    dict.build();
+
+    const size_t block_size = 4096;
+    int thread_count = max(1u, thread::hardware_concurrency());
+    vector<Query> queries(block_size);
+    vector<string> answers(block_size);
+    bool more = true;
+
+    while (more) {
+        size_t n = 0;
+        while (n < block_size && (n == 0 || cin.rdbuf()->in_avail() > 0) && (more = read_query(queries[n], dict.L))) n++;
+        if (n == 0) break;
+
+        atomic<size_t> next(0);
+        auto work = [&]() {
+            for (size_t q; (q = next.fetch_add(1)) < n; ) {
+                answers[q] = answer_query(dict, queries[q]);
+            }
+        };
+        vector<thread> workers;
+        for (int t = 1; t < thread_count && (size_t)t < n; ++t) workers.emplace_back(work);
+        work();
+        for (auto& worker : workers) worker.join();
+
+        string out;
+        for (size_t q = 0; q < n; ++q) {
+            out += answers[q];
+            out += '\n';
+        }
+        cout << out;
+        cout.flush();
+    }
+}
+
 int main() {
     //speed up optimization
     ios_base::sync_with_stdio(false);
@@ -111,6 +303,8 @@ int main() {
         solve_feedback();
     } else if (mode == "FILTER") {
         solve_filter();
+    } else if (mode == "BATCH") {
+        solve_batch();
     }
     
     return 0;
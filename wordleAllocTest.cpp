@@ -0,0 +1,63 @@
+// Checks that play() and solve() do not allocate once the first games are played.
+// build: g++ -std=c++17 -O2 -pthread wordleAllocTest.cpp -o wordleAllocTest && ./wordleAllocTest
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//every global new counts, noinline so gcc does not pair the inlined free() with its own new
+static long long g_allocs = 0;
+__attribute__((noinline)) void* operator new(size_t n) {
+    g_allocs++;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+#define main wordleSolverMain//only ISolver and MySolver are needed
+#include "wordleSolver.cpp"
+#undef main
+
+//allocations over 100 games after 10 to warm up, either through play() or through solve().
+//'repeats' > 0 first plays the same wrong word that often, for games longer than kReservedTurns
+static long long count(IWordGame& game, ISolver& solver, const std::vector<std::string>& words, bool use_solve,
+                       int repeats) {
+    long long before = 0;
+    for (int i = 0; i < 110; ++i) {
+        if (i == 10) before = g_allocs;
+        const std::string& secret = words[i % words.size()];
+        if (use_solve) { solver.solve(game, secret); continue; }
+        game.start(secret);
+        int pattern;
+        uint64_t wrong = IWordGame::packWord(words[(i + 1) % words.size()], game.cfg().L);
+        for (int r = 0; r < repeats; ++r) game.play(wrong, pattern);
+        for (size_t g = 0; g < words.size() && !game.isGameOver(); ++g) {
+            game.play(IWordGame::packWord(words[(i + g) % words.size()], game.cfg().L), pattern);
+        }
+    }
+    return g_allocs - before;
+}
+
+int main() {
+    Config cfg;
+    cfg.L = 5;
+    cfg.dict_words = {"apple", "berry", "chard", "grape", "lemon", "mango", "melon", "peach", "plums", "apric"};
+    cfg.S = (int)cfg.dict_words.size();
+    int failed = 0;
+    //T = 6, then a T far too large to reserve with games of 200 turns
+    for (int T : {6, 1000000000}) {
+        cfg.T = T;
+        int repeats = T > 6 ? 200 : 0;
+        for (const char* kind : {"classic", "hard", "trivial"}) {
+            for (bool use_solve : {false, true}) {
+                std::unique_ptr<IWordGame> game = makeGame(kind, cfg);
+                MySolver solver(cfg);
+                long long allocs = count(*game, solver, {"apple", "grape", "lemon", "mango", "melon", "peach"}, use_solve,
+                                         repeats);
+                std::printf("T=%-10d %-8s %-6s %lld allocations\n", T, kind, use_solve ? "solve" : "play", allocs);
+                if (allocs != 0) failed++;
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "wordle_common.h"
+
+//writes the header for the embedded dictionary build option (see wordle_embedded.h).
+//usage: wordleEmbed L < words.txt > wordle_words.h
+//Words of another length or with letters outside a-z are dropped, duplicates too.
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    int L = argc == 2 ? std::atoi(argv[1]) : 0;
+    if (L < 1 || L > IWordGame::kMaxPackedLength) {
+        std::cerr << "Error: usage wordleEmbed L < words.txt, with L 1.." << IWordGame::kMaxPackedLength << ".\n";
+        return 1;
+    }
+
+    std::vector<uint64_t> words;
+    std::string w;
+    while (std::cin >> w) {
+        uint64_t packed = IWordGame::packWord(w, L);
+        if (packed != IWordGame::kInvalidWord) words.push_back(packed);
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    if (words.empty()) {
+        std::cerr << "Error: no words of length " << L << ".\n";
+        return 1;
+    }
+
+    const size_t n = words.size();
+    std::vector<char> letters(n * L);
+    for (size_t i = 0; i < n; ++i) IWordGame::unpackWord(words[i], L, &letters[i * L]);
+
+    std::cout << "// generated by wordleEmbed, do not edit\n"
+              << "#pragma once\n#include <cstdint>\n\n"
+              << "namespace wordle_embedded {\n"
+              << "constexpr int kLength = " << L << ";\n"
+              << "constexpr int kCount = " << n << ";\n";
+
+    std::cout << "constexpr uint64_t kPacked[" << n << "] = {";
+    for (size_t i = 0; i < n; ++i) {
+        std::cout << (i % 6 == 0 ? "\n    " : " ") << words[i] << "ULL,";
+    }
+    std::cout << "\n};\n";
+
+    std::cout << "constexpr unsigned char kLetterCounts[" << n << "][26] = {";
+    for (size_t i = 0; i < n; ++i) {
+        int counts[26] = {0};
+        for (int k = 0; k < L; ++k) counts[letters[i * L + k] - 'a']++;
+        std::cout << "\n    {";
+        for (int c = 0; c < 26; ++c) std::cout << counts[c] << (c < 25 ? "," : "");
+        std::cout << "},";
+    }
+    std::cout << "\n};\n";
+
+    const char* opening = &letters[0];
+    std::cout << "constexpr uint32_t kOpeningRow[" << n << "] = {";
+    for (size_t i = 0; i < n; ++i) {
+        std::cout << (i % 12 == 0 ? "\n    " : " ") << IWordGame::feedbackCode(&letters[i * L], opening, L) << ',';
+    }
+    std::cout << "\n};\n}\n";
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include "wordle_summary.h"
+
+//merges the PARTIAL lines of a sharded run (wordleSolver --shard=i/N) into the
+//SUMMARY line the same run prints without shards.
+//usage: wordleMerge [--histogram] [--checksum] [--expect-checksum=HEX] [files...]   (reads stdin without files)
+//Other lines are skipped, so whole shard outputs can be piped in as they are.
+//Fails if a shard is missing or shows up twice, and lists the missing ones so
+//only those need to run again.
+//--checksum adds a CHECKSUM line: the merged checksum of every secret covered, the same
+//one a single shard run (--shard=0/1) prints. --expect-checksum=HEX fails if it differs,
+//e.g. when the shards did not all read the same secrets.
+
+static bool readPartials(std::istream& in, std::vector<ShardSpec>& shards, std::vector<BatchStats>& parts) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("PARTIAL", 0) != 0) continue;
+        ShardSpec shard;
+        BatchStats stats;
+        if (!parsePartialLine(line, shard, stats)) {
+            std::cerr << "Error: bad PARTIAL line: " << line << '\n';
+            return false;
+        }
+        shards.push_back(shard);
+        parts.push_back(stats);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    bool histogram = false;
+    bool print_checksum = false;
+    bool expect = false;
+    uint64_t expected_checksum = 0;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--histogram") histogram = true;
+        else if (arg == "--checksum") print_checksum = true;
+        else if (arg.rfind("--expect-checksum=", 0) == 0) {
+            std::istringstream value(arg.substr(18));
+            if (!(value >> std::hex >> expected_checksum)) {
+                std::cerr << "Error: bad checksum in " << arg << ".\n";
+                return 1;
+            }
+            expect = true;
+        }
+        else files.push_back(arg);
+    }
+
+    std::vector<ShardSpec> shards;
+    std::vector<BatchStats> parts;
+    if (files.empty()) {
+        if (!readPartials(std::cin, shards, parts)) return 1;
+    }
+    for (const auto& name : files) {
+        std::ifstream in(name);
+        if (!in) {
+            std::cerr << "Error: cannot open " << name << ".\n";
+            return 1;
+        }
+        if (!readPartials(in, shards, parts)) return 1;
+    }
+    if (shards.empty()) {
+        std::cerr << "Error: no PARTIAL lines found.\n";
+        return 1;
+    }
+
+    //every shard of the same split exactly once. N comes from the input, so only the
+    //shards given are stored, not one flag per shard of the split
+    long long count = shards[0].count;
+    std::set<long long> seen;
+    BatchStats total;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i].count != count) {
+            std::cerr << "Error: shards from different splits (/" << count << " and /" << shards[i].count << ").\n";
+            return 1;
+        }
+        if (!seen.insert(shards[i].index).second) {
+            std::cerr << "Error: shard " << shards[i].index << '/' << count << " given twice.\n";
+            return 1;
+        }
+        total.merge(parts[i]);
+    }
+    if ((long long)seen.size() < count) {
+        //the first few are enough to go on, the loop stops soon however large N is
+        const long long kListed = 20;
+        long long listed = 0;
+        std::cerr << "Error: missing shards:";
+        for (long long i = 0; i < count && listed < kListed; ++i) {
+            if (seen.count(i)) continue;
+            std::cerr << ' ' << i << '/' << count;
+            listed++;
+        }
+        long long missing = count - (long long)seen.size();
+        if (missing > listed) std::cerr << " ... (" << missing << " missing)";
+        std::cerr << '\n';
+        return 1;
+    }
+    if (expect && total.checksum != expected_checksum) {
+        std::cerr << "Error: checksum " << std::hex << std::setw(16) << std::setfill('0') << total.checksum
+                  << " does not match the expected " << std::setw(16) << expected_checksum << ".\n";
+        return 1;
+    }
+
+    std::cout << total.summaryLine();
+    if (histogram) std::cout << total.histogramLine();
+    if (print_checksum) std::cout << "CHECKSUM " << std::hex << std::setw(16) << std::setfill('0') << total.checksum << '\n';
+    return 0;
+}
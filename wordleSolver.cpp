@@ -4,8 +4,23 @@
 #include <set> //alphabetical order,unique
 #include <map>
 #include <algorithm>
+#include <thread>
+#include <deque>
 #include "wordle_common.h"
+#include "wordle_io.h"
+#include "wordle_batch.h"
+#include "wordle_summary.h"
+#include "wordle_trace.h"
 #include <iomanip> // Used for formatting output (std::setprecision)
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <numeric>
+#include <atomic>
+#include <time.h>
 
 //abstract base class
 class ISolver {
@@ -17,171 +32,1048 @@ public:
     virtual std::string chooseBestGuess() = 0;
     virtual void update(std::string guess, std::string pattern) = 0;
     virtual void reset() = 0;
+
+    // Packed versions used by solve(): words as IWordGame::packWord, patterns as encodePattern.
+    // By default they go through the string versions, override them to skip the strings.
+    // 0 means "no guess left"
+    virtual uint64_t chooseBestGuessPacked() {
+        std::string guess = chooseBestGuess();
+        if (guess.empty()) return 0;
+        return IWordGame::packWord(guess, config_.L);
+    }
+    virtual void updatePacked(uint64_t guess, int pattern) {
+        update(IWordGame::unpackWord(guess, config_.L), IWordGame::decodePattern(pattern, config_.L));
+    }
+
+    //what an anytime choice got done before its deadline
+    struct TimedGuess {
+        uint64_t guess;//packed, 0 if no guess left
+        int scored;//how many candidate guesses were fully evaluated
+        int total;//how many there were to evaluate
+    };
+    // Anytime version for expensive policies: return the best guess found by 'deadline'.
+    // Cheap policies just answer, which is what this default does.
+    virtual TimedGuess chooseBestGuessBefore(std::chrono::steady_clock::time_point deadline) {
+        (void)deadline;
+        return {chooseBestGuessPacked(), 1, 1};
+    }
+
+    //how much of the search the timed moves finished, summed over all solve() calls
+    struct SearchStats {
+        long long moves = 0;//moves chosen under a budget
+        long long cut = 0;//moves where the deadline stopped the search early
+        long long scored = 0;
+        long long total = 0;
+        SearchStats& operator+=(const SearchStats& other) {
+            moves += other.moves;
+            cut += other.cut;
+            scored += other.scored;
+            total += other.total;
+            return *this;
+        }
+    };
+    //read feedback from a shared table instead of computing it (COMPARE mode).
+    //false if this policy cannot use it, it then just keeps computing
+    virtual bool usePatternTable(const PatternTable* table) {
+        (void)table;
+        return false;
+    }
+
+    //time per move for solve(), zero means no limit (chooseBestGuessPacked is used)
+    void setMoveBudget(std::chrono::microseconds budget) { move_budget_ = budget; }
+    const SearchStats& searchStats() const { return search_stats_; }
+    //bytes of the buffers a game needs in this solver (their capacity), 0 if it keeps none
+    virtual size_t memoryUsed() const { return 0; }
+
     //constructor and distructor
     explicit ISolver(const Config& cfg) : config_(cfg) {}
     virtual ~ISolver() = default;
 
-    //Game loop
-    int solve(IWordGame& game, const std::string& secret) {
-        //resets solver
+    //Game loop, GUESS/PATTERN lines go into 'out'
+    //pass nullptr for a quiet run, the game history still has every turn
+    int solve(IWordGame& game, const std::string& secret, std::string* out = nullptr) {
+        if (config_.L > IWordGame::kMaxPackedLength) return solveStrings(game, secret, out);
+        begin(game, secret);
+        while (step(game, out)) {}
+        return result(game);
+    }
+
+    //Resumable protocol, solve() one turn at a time. A scheduler that runs many games side
+    //by side keeps one solver per game and calls begin() once, then step() on each game in
+    //turn until it returns false. step() itself is the choose step (choose()), the game's
+    //play() and the observe step (observe()), so a scheduler can also drive those directly.
+    void begin(IWordGame& game, const std::string& secret) {
         reset();
-        //loops until game over
-        //ask for guess,send to game,get pattern,update list based on pattern
         game.start(secret);
-        int guesses_made = 0;
+        guesses_made_ = 0;
+    }
+    //next guess, packed, 0 if the policy has none left
+    uint64_t choose() { return chooseGuess(); }
+    //the game answered 'pattern' to 'guess'
+    void observe(uint64_t guess, int pattern) {
+        guesses_made_++;
+        updatePacked(guess, pattern);
+    }
+    //one turn, GUESS/PATTERN lines go into 'out' like solve().
+    //false once the game is over or the policy gave up
+    bool step(IWordGame& game, std::string* out = nullptr) {
+        if (game.isGameOver()) return false;
+        const int L = config_.L;
+        char letters[IWordGame::kMaxPackedLength];
 
+        uint64_t guess = choose();
+        if (guess == 0) return false;
+
+        int pattern = 0;
+        game.countSolverMemory(memoryUsed());//before play(), the game accounts itself when it ends
+        GuessStatus status = game.play(guess, pattern);
+        if (status != GuessStatus::OK) {
+            if (out) {
+                *out += (status == GuessStatus::NOT_PLAYING) ? "Error: Invalid gamestate" : "Error: Invalid guess";
+                if (status == GuessStatus::INVALID_GUESS && guess != IWordGame::kInvalidWord) {
+                    IWordGame::unpackWord(guess, L, letters);
+                    *out += ": "; out->append(letters, L);
+                }
+                *out += '\n';
+            }
+            return true;
+        }
+        if (out) {
+            IWordGame::unpackWord(guess, L, letters);
+            *out += "GUESS "; out->append(letters, L); *out += '\n';
+            *out += "PATTERN ";
+            IWordGame::decodePattern(pattern, L, letters);
+            out->append(letters, L); *out += '\n';
+        }
+        observe(guess, pattern);
+        return !game.isGameOver();
+    }
+    //steps of the game begun last if it was won, -1 otherwise
+    int result(const IWordGame& game) const { return game.hasWon() ? guesses_made_ : -1; }
+
+private:
+    std::chrono::microseconds move_budget_{0};
+    SearchStats search_stats_;
+    int guesses_made_ = 0;
+
+    //words too long to pack: the same game loop on the string API (makeGuess, chooseBestGuess, update)
+    int solveStrings(IWordGame& game, const std::string& secret, std::string* out) {
+        reset();
+        game.start(secret);
+        guesses_made_ = 0;
         while (!game.isGameOver()) {
             std::string guess = chooseBestGuess();
             if (guess.empty()) break;
 
             std::string pattern;
+            game.countSolverMemory(memoryUsed());
             try {
                 pattern = game.makeGuess(guess);
-                std::cout << "GUESS " << guess << '\n';
-                std::cout << "PATTERN " << pattern << '\n';
             } catch (const std::invalid_argument& e) {
-                std::cout << "Error: " << e.what() << '\n';
+                if (out) { *out += "Error: "; *out += e.what(); *out += '\n'; }
                 continue;
             }
-
-            guesses_made++;
+            if (out) {
+                *out += "GUESS "; *out += guess; *out += '\n';
+                *out += "PATTERN "; *out += pattern; *out += '\n';
+            }
+            guesses_made_++;
             update(guess, pattern);
         }
-        return game.hasWon() ? guesses_made : -1;
+        return result(game);
+    }
+
+    uint64_t chooseGuess() {
+        if (move_budget_.count() <= 0) return chooseBestGuessPacked();
+        TimedGuess choice = chooseBestGuessBefore(std::chrono::steady_clock::now() + move_budget_);
+        search_stats_.moves++;
+        if (choice.scored < choice.total) search_stats_.cut++;
+        search_stats_.scored += choice.scored;
+        search_stats_.total += choice.total;
+        return choice.guess;
     }
 };
+//what the evaluator writes for every game
+enum class OutputMode {
+    TRANSCRIPT,//GAME/GUESS/PATTERN/RESULT lines (the default)
+    SUMMARY,//only SUMMARY and HISTOGRAM at the end
+    LINE,//one line per game
+    BINARY//binary records on stdout, SUMMARY and HISTOGRAM go to stderr
+};
+
+//"transcript", "summary", "line" or "binary"; false if the name is unknown
+static bool parseOutputMode(const std::string& name, OutputMode& mode) {
+    if (name == "transcript") mode = OutputMode::TRANSCRIPT;
+    else if (name == "summary") mode = OutputMode::SUMMARY;
+    else if (name == "line") mode = OutputMode::LINE;
+    else if (name == "binary") mode = OutputMode::BINARY;
+    else return false;
+    return true;
+}
+
+//what replaying a trace found
+struct ReplayReport {
+    long long games = 0;
+    long long mismatches = 0;//games that did not play out exactly as recorded
+    long long first_mismatch = 0;//its number in the trace, from 1
+    double seconds = 0;
+    std::vector<double> latency_us;//per game
+
+    double gamesPerSecond() const { return seconds > 0 ? games / seconds : 0.0; }
+
+    //REPLAY games=<n> mismatches=<n> games_per_sec=<x> p50_us=<x> p90_us=<x> p99_us=<x> max_us=<x>
+    std::string line() const {
+        std::vector<double> sorted = latency_us;
+        std::sort(sorted.begin(), sorted.end());
+        auto pct = [&](double p) { return sorted.empty() ? 0.0 : sorted[(size_t)(p * (sorted.size() - 1))]; };
+        std::ostringstream out;
+        out << "REPLAY games=" << games << " mismatches=" << mismatches
+            << std::fixed << std::setprecision(1)
+            << " games_per_sec=" << gamesPerSecond()
+            << std::setprecision(2)
+            << " p50_us=" << pct(0.50) << " p90_us=" << pct(0.90)
+            << " p99_us=" << pct(0.99) << " max_us=" << pct(1.0) << '\n';
+        return out.str();
+    }
+};
+
+//games_per_sec from a saved REPLAY line, 0 if there is none
+static double readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    std::string word;
+    while (in >> word) {
+        if (word.rfind("games_per_sec=", 0) == 0) return std::atof(word.c_str() + 14);
+    }
+    return 0.0;
+}
+
 // run the test
 class Evaluator {
+    static void appendResult(int result, std::string& out) {
+        if (result != -1) { out += "RESULT WON "; out += std::to_string(result); out += '\n'; }
+        else              out += "RESULT LOST -1\n";
+    }
+
+    //one turn's guess and pattern as letters, from a packed turn or, for long words, a history entry
+    static void appendGuess(const PackedTurn& turn, int L, std::string& out) {
+        char letters[IWordGame::kMaxPackedLength];
+        IWordGame::unpackWord(turn.guess, L, letters);
+        out.append(letters, L);
+    }
+    static void appendGuess(const HistoryEntry& turn, int, std::string& out) { out += turn.guess; }
+    static void appendPattern(const PackedTurn& turn, int L, std::string& out) {
+        char letters[IWordGame::kMaxPackedLength];
+        IWordGame::decodePattern(turn.pattern, L, letters);
+        out.append(letters, L);
+    }
+    static void appendPattern(const HistoryEntry& turn, int, std::string& out) { out += turn.pattern; }
+    //(main refuses binary output for long words, so the second one never sees more than 12 letters)
+    static uint32_t patternCode(const PackedTurn& turn) { return (uint32_t)turn.pattern; }
+    static uint32_t patternCode(const HistoryEntry& turn) { return (uint32_t)IWordGame::encodePattern(turn.pattern); }
+
+    //what the output mode writes for game number 'index' (from 1):
+    // TRANSCRIPT  GAME <i>, GUESS/PATTERN per turn, RESULT
+    // LINE        GAME <i> <secret> WON|LOST <steps> <guess>:<pattern> ...
+    // BINARY      little endian record: u32 secret index (from 0), u8 won, u16 turns, then u32 pattern
+    //             code per turn (3^12 patterns need more than 16 bits, T can go past 255)
+    // SUMMARY     nothing
+    //turns: a game's TurnList, a FinishedGame's vector or, for long words, getHistory()
+    template <typename Turns>
+    static void appendGame(long long index, const std::string& secret, int result, const Turns& turns,
+                           OutputMode mode, int L, std::string& out) {
+        if (mode == OutputMode::TRANSCRIPT) {
+            out += "GAME "; out += std::to_string(index); out += '\n';
+            for (const auto& turn : turns) {
+                out += "GUESS "; appendGuess(turn, L, out); out += '\n';
+                out += "PATTERN "; appendPattern(turn, L, out); out += '\n';
+            }
+            appendResult(result, out);
+        } else if (mode == OutputMode::LINE) {
+            out += "GAME "; out += std::to_string(index);
+            out += ' '; out += secret;
+            out += (result != -1) ? " WON " : " LOST ";
+            out += std::to_string(result);
+            for (const auto& turn : turns) {
+                out += ' '; appendGuess(turn, L, out);
+                out += ':'; appendPattern(turn, L, out);
+            }
+            out += '\n';
+        } else if (mode == OutputMode::BINARY) {
+            uint32_t idx = (uint32_t)(index - 1);
+            for (int b = 0; b < 4; ++b) out += (char)((idx >> (8 * b)) & 0xFF);
+            out += (char)(result != -1 ? 1 : 0);
+            uint16_t count = (uint16_t)turns.size();
+            for (int b = 0; b < 2; ++b) out += (char)((count >> (8 * b)) & 0xFF);
+            for (const auto& turn : turns) {
+                uint32_t code = patternCode(turn);
+                for (int b = 0; b < 4; ++b) out += (char)((code >> (8 * b)) & 0xFF);
+            }
+        }
+    }
+
+    //plays game number 'index' and writes whatever the output mode asks for
+    static void playGame(IWordGame& game, ISolver& solver, long long index, const std::string& secret,
+                         OutputMode mode, BatchStats& stats, std::string& out, TraceWriter* trace) {
+        int result = solver.solve(game, secret);
+        int L = game.cfg().L;
+        if (L > IWordGame::kMaxPackedLength) appendGame(index, secret, result, game.getHistory(), mode, L, out);
+        else appendGame(index, secret, result, game.getTurns(), mode, L, out);
+        stats.record(result, index, secret);
+        if (trace) trace->add(secret, result != -1, game.getTurns());
+    }
+
+    //secrets from the reader thread one at a time, the ones of other shards skipped
+    class SecretFeed {
+    public:
+        SecretFeed(BoundedQueue<std::vector<std::string>>& secrets, const ShardSpec& shard)
+            : secrets_(secrets), shard_(shard) {}
+        //false once the reader closed the queue. 'secret' is valid until the next call
+        bool next(long long& index, const std::string*& secret) {
+            while (open_) {
+                if (next_ == chunk_.size()) {
+                    next_ = 0;
+                    if (!secrets_.pop(chunk_)) { chunk_.clear(); open_ = false; }
+                    continue;
+                }
+                secret = &chunk_[next_++];
+                if (!shard_.owns(++index_)) continue;
+                index = index_;
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        BoundedQueue<std::vector<std::string>>& secrets_;
+        const ShardSpec& shard_;
+        std::vector<std::string> chunk_;
+        size_t next_ = 0;
+        long long index_ = 0;
+        bool open_ = true;
+    };
+
+    //games that run side by side finish out of order: each waits here until every game started
+    //before it is out, then goes to the output, the stats and the trace in input order
+    class InOrderOutput {
+    public:
+        InOrderOutput(OutputWriter& out, OutputMode mode, int L, BatchStats& stats, TraceWriter* trace)
+            : out_(out), mode_(mode), L_(L), stats_(stats), trace_(trace) {}
+        void start(long long index) { started_.push_back(index); }
+        void finish(FinishedGame& game) {
+            long long index = game.index;
+            ready_.emplace(index, std::move(game));
+            for (auto it = ready_.begin(); it != ready_.end() && it->first == started_.front(); it = ready_.erase(it)) {
+                const FinishedGame& done = it->second;
+                appendGame(done.index, done.secret, done.result, done.turns, mode_, L_, out_.buffer());
+                stats_.record(done.result, done.index, done.secret);
+                if (trace_) trace_->add(done.secret, done.result != -1, done.turns);
+                out_.maybeFlush();
+                started_.pop_front();
+            }
+        }
+
+    private:
+        OutputWriter& out_;
+        OutputMode mode_;
+        int L_;
+        BatchStats& stats_;
+        TraceWriter* trace_;
+        std::map<long long, FinishedGame> ready_;
+        std::deque<long long> started_;//indices in the order the games went in
+    };
+
 public:
 //single mode
-    static int evaluateSingleGame(IWordGame& game, ISolver& solver, const std::string& secret) {
-        int result = solver.solve(game, secret);
-        if (result != -1) std::cout << "RESULT WON " << result << '\n';
-        else              std::cout << "RESULT LOST -1\n";
+    static int evaluateSingleGame(IWordGame& game, ISolver& solver, const std::string& secret, OutputWriter& out,
+                                  OutputMode mode = OutputMode::TRANSCRIPT, TraceWriter* trace = nullptr) {
+        std::string& buf = out.buffer();
+        int result;
+        if (mode == OutputMode::TRANSCRIPT) {
+            result = solver.solve(game, secret, &buf);
+            appendResult(result, buf);
+        } else {
+            result = solver.solve(game, secret);
+            if (mode == OutputMode::SUMMARY) appendResult(result, buf);
+            else appendGame(1, secret, result, game.getTurns(), mode, game.cfg().L, buf);
+        }
+        if (trace) trace->add(secret, result != -1, game.getTurns());
         return result;
     }
 //batch mode
 //print result won or summary stats
-    static void evaluateBatch(IWordGame& game, ISolver& solver, const std::vector<std::string>& secrets) {
-        int k = (int)secrets.size();
-        int success = 0, total_steps = 0;
+    static void evaluateBatch(IWordGame& game, ISolver& solver, const std::vector<std::string>& secrets, OutputWriter& out,
+                              OutputMode mode = OutputMode::TRANSCRIPT) {
+        BatchStats stats;
+        for (size_t i = 0; i < secrets.size(); ++i) {
+            playGame(game, solver, (long long)i + 1, secrets[i], mode, stats, out.buffer(), nullptr);
+            out.maybeFlush();
+        }
+        printSummary(stats, mode, out);
+    }
+//streaming batch mode
+//takes chunks of secrets from the reader thread until it closes the queue,
+//so nothing here grows with the number of secrets.
+//Only the games of 'shard' are played, the others are just counted
+    static BatchStats evaluateStream(IWordGame& game, ISolver& solver,
+                                     BoundedQueue<std::vector<std::string>>& secrets, OutputWriter& out,
+                                     OutputMode mode = OutputMode::TRANSCRIPT, const ShardSpec& shard = ShardSpec(),
+                                     TraceWriter* trace = nullptr) {
+        BatchStats stats;
+        std::vector<std::string> chunk;
+        long long index = 0;
+        while (secrets.pop(chunk)) {
+            for (const auto& secret : chunk) {
+                if (!shard.owns(++index)) continue;
+                playGame(game, solver, index, secret, mode, stats, out.buffer(), trace);
+                out.maybeFlush();
+            }
+        }
+        return stats;
+    }
 
-        for (int i = 0; i < k; ++i) {
-            std::cout << "GAME " << (i + 1) << '\n';
-            int result = solver.solve(game, secrets[i]);
-            if (result != -1) {
-                std::cout << "RESULT WON " << result << '\n';
-                ++success;
-                total_steps += result;
-            } else {
-                std::cout << "RESULT LOST -1\n";
+//interleaved batch mode
+//same games as evaluateStream with ClassicWordle + MySolver, but up to 'width' games are in
+//flight at once on this thread (see InterleavedRunner). Games finish out of order, InOrderOutput
+//writes them in input order.
+    static BatchStats evaluateInterleaved(const Config& config, BoundedQueue<std::vector<std::string>>& secrets,
+                                          OutputWriter& out, OutputMode mode, int width,
+                                          const ShardSpec& shard = ShardSpec(), TraceWriter* trace = nullptr) {
+        SharedDictionary dict(config);
+        InterleavedRunner runner(dict, config.T, width);
+        BatchStats stats;
+        SecretFeed feed(secrets, shard);
+        InOrderOutput order(out, mode, config.L, stats, trace);
+        std::vector<FinishedGame> done;
+        long long index;
+        const std::string* secret;
+
+        while (true) {
+            //top up free slots from the reader thread
+            while (runner.hasFreeSlot() && feed.next(index, secret)) {
+                runner.add(index, *secret);
+                order.start(index);
             }
+            if (runner.idle()) break;
+
+            done.clear();
+            runner.tick(done);
+            for (auto& game : done) order.finish(game);
         }
+        return stats;
+    }
+
+//scheduled batch mode
+//any rules and any policy: slot s plays on games[s] with solvers[s], so up to games.size()
+//games are in flight at once on this thread. Every round moves each of them one step()
+//(ISolver's resumable protocol), games that ended go through InOrderOutput like above.
+    static BatchStats evaluateScheduled(std::vector<std::unique_ptr<IWordGame>>& games,
+                                        std::vector<std::unique_ptr<ISolver>>& solvers,
+                                        BoundedQueue<std::vector<std::string>>& secrets, OutputWriter& out,
+                                        OutputMode mode, const ShardSpec& shard = ShardSpec(),
+                                        TraceWriter* trace = nullptr) {
+        struct Slot {
+            long long index = 0;
+            std::string secret;
+        };
+        std::vector<Slot> slots(games.size());
+        std::vector<int> free_slots, active;
+        for (int s = (int)slots.size() - 1; s >= 0; --s) free_slots.push_back(s);
+        BatchStats stats;
+        SecretFeed feed(secrets, shard);
+        InOrderOutput order(out, mode, games[0]->cfg().L, stats, trace);
+        long long index;
+        const std::string* secret;
 
-        double avg = (success > 0) ? (double)total_steps / success : 0.0;
-        std::cout << "SUMMARY success=" << success << "/" << k
-                  << " avg_steps=" << std::fixed << std::setprecision(2) << avg
-                  << '\n';
+        while (true) {
+            while (!free_slots.empty() && feed.next(index, secret)) {
+                int s = free_slots.back();
+                free_slots.pop_back();
+                slots[s].index = index;
+                slots[s].secret = *secret;
+                solvers[s]->begin(*games[s], *secret);
+                active.push_back(s);
+                order.start(index);
+            }
+            if (active.empty()) break;
+
+            for (size_t a = 0; a < active.size(); ) {
+                int s = active[a];
+                IWordGame& game = *games[s];
+                if (solvers[s]->step(game)) {
+                    ++a;
+                    continue;
+                }
+                FinishedGame done;
+                done.index = slots[s].index;
+                done.secret = slots[s].secret;
+                done.result = solvers[s]->result(game);
+                //summary output without a trace never looks at the turns
+                if (mode != OutputMode::SUMMARY || trace) done.turns.assign(game.getTurns().begin(), game.getTurns().end());
+                order.finish(done);
+                free_slots.push_back(s);
+                active[a] = active.back();
+                active.pop_back();
+            }
+        }
+        return stats;
     }
-};
 
-//my code
+//replay mode
+//plays every game of a recorded trace again, checks that each guess, pattern and result is the
+//same as recorded, and times each game
+    static ReplayReport replayTrace(IWordGame& game, ISolver& solver, TraceReader& trace) {
+        ReplayReport report;
+        TraceGame recorded;
+        auto run_start = std::chrono::steady_clock::now();
+        while (trace.next(recorded)) {
+            ++report.games;
+            auto start = std::chrono::steady_clock::now();
+            int result = solver.solve(game, recorded.secret);
+            auto end = std::chrono::steady_clock::now();
+            report.latency_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
 
-class MySolver : public ISolver {
-    //set automically keeps words sorted alphabetically,prevents duplicates
-    //lexicographically smallest
-    std::set<std::string> candidates_;
+            const auto& turns = game.getTurns();
+            bool same = (result != -1) == recorded.won && turns.size() == recorded.turns.size();
+            for (size_t t = 0; same && t < turns.size(); ++t) {
+                same = turns[t].guess == recorded.turns[t].guess && turns[t].pattern == recorded.turns[t].pattern;
+            }
+            if (!same && report.mismatches++ == 0) report.first_mismatch = report.games;
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+        return report;
+    }
 
-    // Helper function: Logic to check if a word is consistent with the feedback.
-    // Simulates: If 'candidate' was the secret, would 'guess' produce 'pattern'?
-    std::string generatePattern(const std::string& candidate, const std::string& guess) {
-        std::string res(guess.length(), 'B'); // assume all Black
-        std::map<char, int> counts;//Keeps track of letter frequency in the candidate
-        //map for key value pairs
+    //SUMMARY line, other modes also get "HISTOGRAM lost=<n> 1=<n> 2=<n> ..."
+    static void printSummary(const BatchStats& stats, OutputMode mode, OutputWriter& out) {
+        std::string lines = stats.summaryLine();
+        if (mode != OutputMode::TRANSCRIPT) lines += stats.histogramLine();
+        if (mode == OutputMode::BINARY) std::cerr << lines;
+        else out.buffer() += lines;
+    }
+    //a sharded run prints its PARTIAL line instead, wordleMerge turns those back into the SUMMARY
+    static void printPartial(const ShardSpec& shard, const BatchStats& stats, OutputMode mode, OutputWriter& out) {
+        if (mode == OutputMode::BINARY) std::cerr << partialLine(shard, stats);
+        else out.buffer() += partialLine(shard, stats);
+    }
+};
 
+//reader thread for BATCH/STREAM: parses and checks "SECRET <word>" lines and
+//hands them over in chunks. limit < 0 means read until end of input.
+//On bad input it fills 'error' and stops, the queue is always closed at the end.
+static void readSecrets(BoundedQueue<std::vector<std::string>>& queue, int L, long long limit,
+                        std::string& error) {
+    const size_t chunk_size = 1024;
+    std::vector<std::string> chunk;
+    chunk.reserve(chunk_size);
+    std::string secret_header, secret;
 
-        // Count character frequencies in the candidate (hypothetical secret)
-        for (char c : candidate) {
-            counts[c]++;
+    for (long long i = 0; limit < 0 || i < limit; ++i) {
+        if (!(std::cin >> secret_header)) {
+            if (limit >= 0) error = "Error: invalid BATCH secret line at GAME " + std::to_string(i + 1) + ".";
+            break;
+        }
+        if (!(std::cin >> secret) || secret_header != "SECRET") {
+            error = "Error: invalid BATCH secret line at GAME " + std::to_string(i + 1) + ".";
+            break;
+        }
+        if ((int)secret.size() != L) {
+            error = "Error: SECRET length != word_length at GAME " + std::to_string(i + 1) + ".";
+            break;
+        }
+        chunk.push_back(secret);
+        if (chunk.size() == chunk_size) {
+            if (!queue.push(std::move(chunk))) break;
+            chunk.clear();
+            chunk.reserve(chunk_size);
         }
+    }
+    if (!chunk.empty()) queue.push(std::move(chunk));
+    queue.close();
+}
+
+//my code
 
-        // Pass 1: Identify Greens (Correct Letter, Correct Position)
-        //higher priority than yellow
-        for (size_t i = 0; i < guess.length(); ++i) {
-            if (candidate[i] == guess[i]) {
-                res[i] = 'G';//mark green
-                counts[candidate[i]]--;//use one instance of this letter
+class MySolver : public ISolver {
+protected:
+    //every dictionary word packed (IWordGame::packWord), sorted, no duplicates.
+    //packed order is alphabetical order, so sorting the numbers sorts the words.
+    //shared with the other solvers when the config already carries the packed list
+    std::shared_ptr<const std::vector<uint64_t>> all_words_;
+    //words still consistent with the feedback, kept in the same order,
+    //so the first one is the lexicographically smallest
+    std::vector<uint64_t> candidates_;
+    //universe mode (S == 0): no list at all, the history is kept as constraints and
+    //the smallest word that meets them is generated on demand
+    bool is_universe_;
+    UniverseConstraints constraints_;
+    //shared feedback table over all_words_, null without one
+    const PatternTable* patterns_ = nullptr;
+    //table positions of candidates_, only kept with a table
+    std::vector<int> candidate_ids_;
+    //L > IWordGame::kMaxPackedLength: nothing packs, the same lists are kept as strings
+    //and only the string API (chooseBestGuess/update) plays
+    bool long_words_;
+    std::vector<std::string> all_strings_;
+    std::vector<std::string> string_candidates_;
+
+public:
+    explicit MySolver(const Config& cfg)
+        : ISolver(cfg), is_universe_(cfg.S == 0), constraints_(cfg.L),
+          long_words_(cfg.L > IWordGame::kMaxPackedLength) {
+        if (long_words_) {
+            for (const auto& word : config_.dict_words) {
+                if (IWordGame::isLetters(word, config_.L)) all_strings_.push_back(word);
             }
+            std::sort(all_strings_.begin(), all_strings_.end());
+            all_strings_.erase(std::unique(all_strings_.begin(), all_strings_.end()), all_strings_.end());
+            return;
         }
-
-        // Pass 2: Identify Yellows (Correct Letter, Wrong Position)
-        for (size_t i = 0; i < guess.length(); ++i) {
-            if (res[i] != 'G') { // Only check if not already marked Green
-                //is it in candidate?
-                if (counts[guess[i]] > 0) {
-                    res[i] = 'Y';//mark yellow
-                    counts[guess[i]]--;//use up this letter
-                }
+        if (cfg.packed_words) {
+            all_words_ = cfg.packed_words;//shared, already packed and sorted
+        } else if (cfg.embedded) {
+            // compiled in already packed and sorted
+            all_words_ = std::make_shared<std::vector<uint64_t>>(wordle_embedded::kPacked,
+                                                                 wordle_embedded::kPacked + wordle_embedded::kCount);
+        } else {
+            auto words = std::make_shared<std::vector<uint64_t>>();
+            for (const auto& word : config_.dict_words) {
+                uint64_t packed = IWordGame::packWord(word, config_.L);
+                if (packed != IWordGame::kInvalidWord) words->push_back(packed);
             }
+            std::sort(words->begin(), words->end());
+            words->erase(std::unique(words->begin(), words->end()), words->end());
+            all_words_ = words;
         }
-        return res;//return calculated pattern(eg:GGYYB)
+        candidates_.reserve(all_words_->size());
     }
 
-public:
-    explicit MySolver(const Config& cfg) : ISolver(cfg) {}
+    //the table has to be over the same words, otherwise it is not used
+    bool usePatternTable(const PatternTable* table) override {
+        if (is_universe_ || !table || table->words() != *all_words_) return false;
+        patterns_ = table;
+        candidate_ids_.reserve(all_words_->size());
+        return true;
+    }
+
+    //the candidate lists, the dictionary itself is shared and not counted.
+    //long words: their letters are counted once per candidate, on the heap or not
+    size_t memoryUsed() const override {
+        return candidates_.capacity() * sizeof(uint64_t) + candidate_ids_.capacity() * sizeof(int) +
+               string_candidates_.capacity() * sizeof(std::string) + string_candidates_.size() * (config_.L + 1);
+    }
 //reset function
     void reset() override {
-        // Clear the set to remove data from previous games
-        candidates_.clear();
-        
-        // Insert all dictionary from config_ into the set.
-        // std::set automatically sorts elements,lexicographically smallest
-        for (const auto& word : config_.dict_words) {
-            candidates_.insert(word);
+        if (is_universe_) {
+            constraints_.reset(config_.L);
+            return;
+        }
+        if (long_words_) {
+            string_candidates_ = all_strings_;
+            return;
+        }
+        // Start again from the whole dictionary.
+        // capacity is already there, so this is just a copy
+        candidates_.assign(all_words_->begin(), all_words_->end());
+        if (patterns_) {
+            candidate_ids_.resize(all_words_->size());
+            std::iota(candidate_ids_.begin(), candidate_ids_.end(), 0);
         }
     }
 //choose best guess
     std::string chooseBestGuess() override {
-        // If the set is empty, return empty string (stops game loop)
-        if (candidates_.empty()) return "";
-        
-        // return the first element
-        // std::set used, the first element is the lexicographically smallest
-        return *candidates_.begin();
+        if (long_words_) {
+            if (is_universe_) {
+                char word[UniverseConstraints::kMaxLength];
+                return constraints_.smallest(word) ? std::string(word, config_.L) : "";
+            }
+            return string_candidates_.empty() ? "" : string_candidates_.front();
+        }
+        uint64_t guess = chooseBestGuessPacked();
+        // If nothing is left, return empty string (stops game loop)
+        if (guess == 0) return "";
+        return IWordGame::unpackWord(guess, config_.L);
+    }
+    uint64_t chooseBestGuessPacked() override {
+        if (long_words_) return 0;//nothing that long packs, solve() plays the strings
+        if (is_universe_) {
+            char word[IWordGame::kMaxPackedLength];
+            if (!constraints_.smallest(word)) return 0;
+            return IWordGame::packWord(std::string(word, config_.L), config_.L);
+        }
+        // return the first element, the lexicographically smallest
+        return candidates_.empty() ? 0 : candidates_.front();
     }
 //update to filter my list
     void update(std::string guess, std::string pattern) override {
-        // Iterate through all current candidates
-        for (auto it = candidates_.begin(); it != candidates_.end(); ) {
-            // Check,If the word (*it) was the secret, would it produce this 'pattern' for this 'guess'
-            if (generatePattern(*it, guess) != pattern) {
-                // NO, It cannot be the secret word, Remove 
-                // erase(it) removes the element and returns an iterator to the next element.
-                it = candidates_.erase(it);
-            } else {
-                // YES, It might be the secret, keep and move to next
-                ++it;
+        if (long_words_) {
+            if (is_universe_) {
+                constraints_.add(guess, pattern);
+                return;
+            }
+            // same filter as updatePacked, on strings
+            auto keep_end = std::remove_if(string_candidates_.begin(), string_candidates_.end(),
+                                           [&](const std::string& word) { return IWordGame::feedback(word, guess) != pattern; });
+            string_candidates_.erase(keep_end, string_candidates_.end());
+            return;
+        }
+        updatePacked(IWordGame::packWord(guess, config_.L), IWordGame::encodePattern(pattern));
+    }
+    void updatePacked(uint64_t guess, int pattern) override {
+        if (long_words_) return;
+        if (is_universe_) {
+            constraints_.add(guess, pattern);
+            return;
+        }
+        if (patterns_) {
+            // every pattern of a dictionary guess is in the shared table, candidate_ids_ moves
+            // along with candidates_. A guess from outside the dictionary still gets computed
+            int g = patterns_->indexOf(guess);
+            const uint16_t* row = g >= 0 ? patterns_->row(g) : nullptr;
+            char guess_letters[IWordGame::kMaxPackedLength];
+            char letters[IWordGame::kMaxPackedLength];
+            if (!row) IWordGame::unpackWord(guess, config_.L, guess_letters);
+            size_t keep = 0;
+            for (size_t i = 0; i < candidates_.size(); ++i) {
+                int code;
+                if (row) {
+                    code = row[candidate_ids_[i]];
+                } else {
+                    IWordGame::unpackWord(candidates_[i], config_.L, letters);
+                    code = IWordGame::feedbackCode(letters, guess_letters, config_.L);
+                }
+                if (code != pattern) continue;
+                candidates_[keep] = candidates_[i];
+                candidate_ids_[keep++] = candidate_ids_[i];
+            }
+            candidates_.resize(keep);
+            candidate_ids_.resize(keep);
+            return;
+        }
+        // opening move on the embedded dictionary: every word's pattern is in the table already.
+        // candidates_ is always a sorted subset of all_words_, so same size means the whole list
+        if (config_.embedded && guess == wordle_embedded::openingGuess() && candidates_.size() == all_words_->size()) {
+            candidates_.clear();
+            for (int i = 0; i < wordle_embedded::kCount; ++i) {
+                if ((int)wordle_embedded::kOpeningRow[i] == pattern) candidates_.push_back(wordle_embedded::kPacked[i]);
+            }
+            return;
+        }
+        const int L = config_.L;
+        char guess_letters[IWordGame::kMaxPackedLength];
+        char letters[IWordGame::kMaxPackedLength];
+        IWordGame::unpackWord(guess, L, guess_letters);
+        // Keep a word only if, were it the secret, 'guess' would produce this 'pattern'.
+        // remove_if keeps the order, so the list stays sorted
+        auto keep_end = std::remove_if(candidates_.begin(), candidates_.end(), [&](uint64_t word) {
+            IWordGame::unpackWord(word, L, letters);
+            return IWordGame::feedbackCode(letters, guess_letters, L) != pattern;
+        });
+        candidates_.erase(keep_end, candidates_.end());
+    }
+};
+
+// Picks the candidate that splits the candidates best: the smallest sum of squared
+// pattern group sizes, i.e. the smallest expected number of words left. Ties go to the
+// alphabetically smaller word. Scoring one guess costs a pass over all candidates, so a full
+// choice is O(n^2) and this policy is anytime: guesses are scored best-first by a cheap
+// letter frequency score, and at the deadline the best one scored so far is played.
+class PartitionSolver : public MySolver {
+    std::vector<int> bucket_;//candidates per pattern code, all zero between guesses
+    std::vector<int> touched_;//codes to set back to zero
+    std::vector<char> letters_;//the candidates unpacked, L letters each
+    std::vector<std::pair<int, int>> order_;//(-letter score, candidate position)
+
+public:
+    explicit PartitionSolver(const Config& cfg) : MySolver(cfg) {
+        if (cfg.L > IWordGame::kMaxPackedLength) return;//main refuses it, 3^L codes would not fit
+        int codes = 1;
+        for (int i = 0; i < cfg.L; ++i) codes *= 3;
+        bucket_.assign(codes, 0);
+    }
+
+    uint64_t chooseBestGuessPacked() override {
+        return chooseBestGuessBefore(std::chrono::steady_clock::time_point::max()).guess;
+    }
+
+    size_t memoryUsed() const override {
+        return MySolver::memoryUsed() + (bucket_.capacity() + touched_.capacity()) * sizeof(int) + letters_.capacity() +
+               order_.capacity() * sizeof(std::pair<int, int>);
+    }
+
+    TimedGuess chooseBestGuessBefore(std::chrono::steady_clock::time_point deadline) override {
+        // two words or less: every guess splits them the same way, so the smallest wins anyway
+        if (is_universe_ || candidates_.size() <= 2) return {MySolver::chooseBestGuessPacked(), 1, 1};
+        const int L = config_.L;
+        const int n = (int)candidates_.size();
+
+        // cheap pass: how many candidates have each letter, a word scores the letters it covers
+        int freq[26] = {0};
+        letters_.resize((size_t)n * L);
+        for (int i = 0; i < n; ++i) {
+            char* w = &letters_[(size_t)i * L];
+            IWordGame::unpackWord(candidates_[i], L, w);
+            int seen = 0;
+            for (int k = 0; k < L; ++k) {
+                int c = w[k] - 'a';
+                if (!(seen >> c & 1)) freq[c]++;
+                seen |= 1 << c;
+            }
+        }
+        order_.resize(n);
+        for (int i = 0; i < n; ++i) {
+            const char* w = &letters_[(size_t)i * L];
+            int seen = 0, score = 0;
+            for (int k = 0; k < L; ++k) {
+                int c = w[k] - 'a';
+                if (!(seen >> c & 1)) score += freq[c];
+                seen |= 1 << c;
             }
+            order_[i] = {-score, i};
         }
+        std::sort(order_.begin(), order_.end());
+
+        // refine: the exact split of each guess in that order until time runs out
+        int best = -1, scored = 0;
+        long long best_score = 0;
+        for (const auto& entry : order_) {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            int g = entry.second;
+            const char* guess = &letters_[(size_t)g * L];
+            const uint16_t* row = patterns_ ? patterns_->row(candidate_ids_[g]) : nullptr;
+            long long score = 0;
+            for (int j = 0; j < n; ++j) {
+                int code = row ? row[candidate_ids_[j]] : IWordGame::feedbackCode(&letters_[(size_t)j * L], guess, L);
+                if (bucket_[code] == 0) touched_.push_back(code);
+                score += 2 * bucket_[code] + 1;//(b+1)^2 - b^2
+                bucket_[code]++;
+            }
+            for (int code : touched_) bucket_[code] = 0;
+            touched_.clear();
+            ++scored;
+            if (best < 0 || score < best_score || (score == best_score && g < best)) {
+                best = g;
+                best_score = score;
+            }
+        }
+        // nothing scored in time: the plain lexicographic choice
+        if (best < 0) return {MySolver::chooseBestGuessPacked(), 0, n};
+        return {candidates_[best], scored, n};
+    }
+};
+
+//every policy --policy and --compare can name. A new ISolver only needs a line here
+struct PolicyEntry {
+    const char* name;
+    std::unique_ptr<ISolver> (*make)(const Config& cfg);
+};
+static const PolicyEntry kPolicies[] = {
+    {"lex", [](const Config& cfg) { return std::unique_ptr<ISolver>(new MySolver(cfg)); }},
+    {"partition", [](const Config& cfg) { return std::unique_ptr<ISolver>(new PartitionSolver(cfg)); }},
+};
+
+static const PolicyEntry* findPolicy(const std::string& name) {
+    for (const auto& entry : kPolicies) {
+        if (name == entry.name) return &entry;
     }
+    return nullptr;
+}
+
+static std::unique_ptr<IWordGame> makeGame(const std::string& kind, const Config& cfg) {
+    if (kind == "hard") return std::unique_ptr<IWordGame>(new HardWordle(cfg));
+    if (kind == "trivial") return std::unique_ptr<IWordGame>(new TrivialWordle(cfg));
+    return std::unique_ptr<IWordGame>(new ClassicWordle(cfg));
+}
+
+//one column of a comparison: a registered policy, optionally with its own move budget ("partition@500")
+struct PolicyRun {
+    std::string label;
+    const PolicyEntry* policy;
+    long long move_budget_us;
+    BatchStats stats;
+    double cpu_ms = 0;//thread CPU time of the games, not counting the shared setup
+
+    PolicyRun(const std::string& label, const PolicyEntry* policy, long long move_budget_us)
+        : label(label), policy(policy), move_budget_us(move_budget_us) {}
 };
 
+//"lex,partition@500", every registered policy if 'list' is empty
+static bool parsePolicyRuns(const std::string& list, long long default_budget_us, std::vector<PolicyRun>& runs) {
+    if (list.empty()) {
+        for (const auto& entry : kPolicies) runs.emplace_back(entry.name, &entry, default_budget_us);
+        return true;
+    }
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        size_t at = item.find('@');
+        long long budget = default_budget_us;
+        if (at != std::string::npos && (budget = std::atoll(item.c_str() + at + 1)) <= 0) return false;
+        const PolicyEntry* policy = findPolicy(item.substr(0, at));
+        if (!policy) return false;
+        runs.emplace_back(item, policy, budget);
+    }
+    return !runs.empty();
+}
+
+static double threadCpuMs() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+//compare mode
+//every policy plays every secret on its own thread with its own game and solver.
+//'cfg' carries the shared packed dictionary and 'table' the shared feedback table (or null),
+//both are only read here, so the policies cost nothing but their own solving
+static void comparePolicies(const Config& cfg, const std::string& game_kind, const std::vector<std::string>& secrets,
+                            const PatternTable* table, std::vector<PolicyRun>& runs) {
+    std::vector<std::thread> workers;
+    for (auto& run : runs) {
+        workers.emplace_back([&cfg, &game_kind, &secrets, table, &run] {
+            std::unique_ptr<IWordGame> game = makeGame(game_kind, cfg);
+            std::unique_ptr<ISolver> solver = run.policy->make(cfg);
+            solver->setMoveBudget(std::chrono::microseconds(run.move_budget_us));
+            solver->usePatternTable(table);
+            double start = threadCpuMs();
+            for (size_t i = 0; i < secrets.size(); ++i) {
+                run.stats.record(solver->solve(*game, secrets[i]), (long long)i + 1, secrets[i]);
+            }
+            run.cpu_ms = threadCpuMs() - start;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+//one row per policy:
+//policy  success  rate  avg_steps  worst  cpu_ms  lost  1  2 ...  (games won in that many steps)
+static std::string compareTable(const std::vector<PolicyRun>& runs) {
+    size_t steps = 1;
+    for (const auto& run : runs) steps = std::max(steps, run.stats.steps_hist.size());
+    std::ostringstream out;
+    out << std::left << std::setw(20) << "policy" << std::right << std::setw(12) << "success"
+        << std::setw(9) << "rate" << std::setw(11) << "avg_steps" << std::setw(7) << "worst"
+        << std::setw(12) << "cpu_ms" << std::setw(8) << "lost";
+    for (size_t s = 1; s < steps; ++s) out << std::setw(8) << s;
+    out << '\n';
+    for (const auto& run : runs) {
+        const BatchStats& st = run.stats;
+        double rate = st.games > 0 ? 100.0 * st.success / st.games : 0.0;
+        double avg = st.success > 0 ? (double)st.total_steps / st.success : 0.0;
+        out << std::left << std::setw(20) << run.label << std::right
+            << std::setw(12) << (std::to_string(st.success) + "/" + std::to_string(st.games))
+            << std::fixed << std::setprecision(2)
+            << std::setw(8) << rate << '%' << std::setw(11) << avg << std::setw(7) << st.worst
+            << std::setw(12) << run.cpu_ms;
+        for (size_t s = 0; s < steps; ++s) out << std::setw(8) << (s < st.steps_hist.size() ? st.steps_hist[s] : 0);
+        out << '\n';
+    }
+    return out.str();
+}
+
 //reads input(Mode, Config, Dictionary, Secrets).
 //Creates the ClassicWordle game object.
 //creates MySolver object
 //runs evaluator
-int main() {
+//options: --output=transcript|summary|line|binary
+//         --interleave=N  play N games at once on one thread (BATCH/STREAM only). Classic rules
+//                         with lex on a dictionary share the filtering (InterleavedRunner), any
+//                         other game/policy runs N game+solver slots through ISolver::step()
+//         --shard=i/N     play only games g with (g - 1) % N == i and print a PARTIAL line
+//         --policy=lex|partition        lex is MySolver, partition is PartitionSolver (see kPolicies)
+//         --move-budget-us=N            time limit per move, prints a SEARCH line on stderr
+//         --game=classic|hard|trivial   game rules (classic by default)
+//         --record=FILE   write a binary trace of every game played
+//         --trace=FILE    REPLAY mode: the trace to play back
+//         --baseline=FILE REPLAY mode: fail (exit 3) if games/sec drops more than
+//                         --max-regression=X (default 0.10) below the REPLAY line saved in FILE
+//         --write-baseline=FILE  REPLAY mode: save this run's REPLAY line
+//         --memory        print a MEMORY line on stderr: bytes per game from the game arenas,
+//                         peak arena bytes and peak RSS of the process
+//         --embedded      use the dictionary compiled in (see wordle_embedded.h), the input
+//                         then goes straight from "L T" to the secrets
+//         --compare=LIST  COMPARE mode: the policies to run side by side, e.g. lex,partition@500
+//                         (@N is that run's move budget in us), every registered one by default
+//         --table-mb=N    COMPARE mode: largest shared pattern table in MB (64 by default, 0 turns it off),
+//                         the reason goes to stderr when the table is skipped
+//COMPARE reads secrets to the end of the input like STREAM and prints one table row per policy
+int main(int argc, char** argv) {
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
+    OutputMode output_mode = OutputMode::TRANSCRIPT;
+    int interleave = 0;
+    ShardSpec shard;
+    bool sharded = false;
+    std::string policy = "lex";
+    long long move_budget_us = 0;
+    std::string game_kind = "classic";
+    std::string record_path, trace_path, baseline_path, write_baseline_path;
+    double max_regression = 0.10;
+    bool embedded = false;
+    bool memory = false;
+    std::string compare_list;
+    long long table_mb = -1;//COMPARE pattern table limit, PatternTable::kDefaultMaxBytes if not given
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--output=", 0) == 0 && parseOutputMode(arg.substr(9), output_mode)) continue;
+        if (arg.rfind("--interleave=", 0) == 0 && (interleave = std::atoi(arg.c_str() + 13)) > 0) continue;
+        if (arg.rfind("--shard=", 0) == 0 && (sharded = shard.parse(arg.substr(8)))) continue;
+        if (arg.rfind("--policy=", 0) == 0 && findPolicy(arg.substr(9))) { policy = arg.substr(9); continue; }
+        if (arg.rfind("--compare=", 0) == 0) { compare_list = arg.substr(10); continue; }
+        if (arg.rfind("--move-budget-us=", 0) == 0 && (move_budget_us = std::atoll(arg.c_str() + 17)) > 0) continue;
+        if (arg == "--game=classic" || arg == "--game=hard" || arg == "--game=trivial") { game_kind = arg.substr(7); continue; }
+        if (arg.rfind("--record=", 0) == 0) { record_path = arg.substr(9); continue; }
+        if (arg.rfind("--trace=", 0) == 0) { trace_path = arg.substr(8); continue; }
+        if (arg.rfind("--baseline=", 0) == 0) { baseline_path = arg.substr(11); continue; }
+        if (arg.rfind("--write-baseline=", 0) == 0) { write_baseline_path = arg.substr(17); continue; }
+        if (arg.rfind("--max-regression=", 0) == 0) { max_regression = std::atof(arg.c_str() + 17); continue; }
+        if (arg == "--embedded") { embedded = true; continue; }
+        if (arg == "--memory") { memory = true; continue; }
+        if (arg.rfind("--table-mb=", 0) == 0 && (table_mb = std::atoll(arg.c_str() + 11)) >= 0) continue;
+        std::cerr << "Error: unknown option " << arg
+                  << " (use --output=transcript|summary|line|binary, --interleave=N, --shard=i/N,"
+                  << " --policy=lex|partition, --move-budget-us=N, --game=classic|hard|trivial,"
+                  << " --record=FILE, --trace=FILE, --baseline=FILE, --write-baseline=FILE, --max-regression=X, --embedded, --memory, --compare=LIST, --table-mb=N).\n";
+        return 1;
+    }
+
     std::string mode;
     std::cin >> mode;
+    if (interleave > 0 && mode != "BATCH" && mode != "STREAM") {
+        std::cerr << "Error: --interleave only works in BATCH and STREAM mode.\n";
+        return 1;
+    }
+    if (table_mb >= 0 && mode != "COMPARE") {
+        std::cerr << "Error: --table-mb only works in COMPARE mode.\n";
+        return 1;
+    }
 
     Config config;
     std::cin >> config.L >> config.T;
+    if (config.L < 1 || config.T < 1) {
+        std::cerr << "Error: word_length and tries must be positive.\n";
+        return 1;
+    }
+    if (output_mode == OutputMode::BINARY && config.T > 65535) {
+        std::cerr << "Error: --output=binary stores the turn count in 16 bits, tries must be at most 65535.\n";
+        return 1;
+    }
+
+    if (embedded) {
+        if (!wordle_embedded::kAvailable) {
+            std::cerr << "Error: --embedded needs a build with -DWORDLE_EMBEDDED_DICT.\n";
+            return 1;
+        }
+        if (config.L != wordle_embedded::kLength) {
+            std::cerr << "Error: the embedded dictionary has words of length " << wordle_embedded::kLength << ".\n";
+            return 1;
+        }
+        config.embedded = true;
+    }
 
-    int dict_count = 0;
-    std::cin >> dict_count;
+    int dict_count = 0;//no dictionary block with --embedded
+    if (!embedded) std::cin >> dict_count;
+    config.S = embedded ? wordle_embedded::kCount : dict_count;//S == 0 would make the game build all 26^L strings
     config.dict_words.clear();
     config.dict_words.reserve(dict_count);
 
@@ -194,9 +1086,98 @@ int main() {
         }
         if ((int)w.size() == config.L) config.dict_words.push_back(w);
     }
-    ClassicWordle game(config);
-    MySolver solver(config);
-    if (mode == "SINGLE") {
+    if (config.L > IWordGame::kMaxPackedLength) {
+        //too long to pack: only the string API of the games and of MySolver plays
+        if (policy != "lex" || interleave > 0 || embedded || mode == "REPLAY" || mode == "COMPARE" || !record_path.empty() ||
+            output_mode == OutputMode::LINE || output_mode == OutputMode::BINARY) {
+            std::cerr << "Error: words longer than " << IWordGame::kMaxPackedLength << " letters only play with --policy=lex and"
+                      << " transcript or summary output (no --interleave, --embedded, --record, REPLAY or COMPARE).\n";
+            return 1;
+        }
+        if (config.S == 0 && config.L > UniverseConstraints::kMaxLength) {
+            std::cerr << "Error: without a dictionary word_length must be at most " << UniverseConstraints::kMaxLength << ".\n";
+            return 1;
+        }
+    }
+    auto prep_start = std::chrono::steady_clock::now();
+    if ((mode == "COMPARE" || interleave > 0) && config.S > 0 && !embedded) {
+        //pack and sort once, every policy's (or slot's) game and solver then shares the list
+        auto packed = std::make_shared<std::vector<uint64_t>>();
+        for (const auto& w : config.dict_words) {
+            uint64_t p = IWordGame::packWord(w, config.L);
+            if (p != IWordGame::kInvalidWord) packed->push_back(p);
+        }
+        std::sort(packed->begin(), packed->end());
+        packed->erase(std::unique(packed->begin(), packed->end()), packed->end());
+        config.packed_words = packed;
+        std::vector<std::string>().swap(config.dict_words);
+    }
+    std::unique_ptr<IWordGame> game_ptr = makeGame(game_kind, config);
+    IWordGame& game = *game_ptr;
+    std::unique_ptr<ISolver> solver_ptr = findPolicy(policy)->make(config);
+    ISolver& solver = *solver_ptr;
+    solver.setMoveBudget(std::chrono::microseconds(move_budget_us));
+    //with --interleave the slots' own solvers play instead, their counts are added in here
+    ISolver::SearchStats slot_search;
+    std::unique_ptr<TraceWriter> trace_out;
+    if (!record_path.empty() && mode != "REPLAY") {
+        if (config.T > 65535) {
+            std::cerr << "Error: --record stores the turn count in 16 bits, tries must be at most 65535.\n";
+            return 1;
+        }
+        std::FILE* file = std::fopen(record_path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Error: cannot write " << record_path << ".\n";
+            return 1;
+        }
+        trace_out.reset(new TraceWriter(file, config));
+    }
+    OutputWriter out;
+    if (mode == "REPLAY") {
+        TraceReader trace(trace_path.empty() ? nullptr : std::fopen(trace_path.c_str(), "rb"));
+        if (!trace.ok()) {
+            std::cerr << "Error: REPLAY needs --trace=FILE with a trace recorded by --record.\n";
+            return 1;
+        }
+        if (trace.length() != config.L || trace.tries() != config.T || trace.hash() != configHash(config)) {
+            std::cerr << "Error: the trace was recorded with a different word_length, tries or dictionary.\n";
+            return 1;
+        }
+        ReplayReport report = Evaluator::replayTrace(game, solver, trace);
+        std::string line = report.line();
+        out.buffer() += line;
+        out.finish();
+        if (trace.truncated()) {
+            std::cerr << "Error: the trace is cut off after game " << report.games << ".\n";
+            return 1;
+        }
+        if (report.mismatches > 0) {
+            std::cerr << "Error: " << report.mismatches << " games differ from the trace, first one is game "
+                      << report.first_mismatch << ".\n";
+            return 2;
+        }
+        if (!baseline_path.empty()) {
+            double baseline = readBaseline(baseline_path);
+            if (baseline <= 0) {
+                std::cerr << "Error: no games_per_sec in " << baseline_path << ".\n";
+                return 1;
+            }
+            if (report.gamesPerSecond() < baseline * (1.0 - max_regression)) {
+                std::cerr << "Error: throughput " << report.gamesPerSecond() << " games/sec is more than "
+                          << max_regression * 100 << "% below the baseline " << baseline << ".\n";
+                return 3;
+            }
+        }
+        //only a run that passed becomes the new baseline
+        if (!write_baseline_path.empty()) {
+            std::ofstream file(write_baseline_path);
+            if (!(file << line) || !(file.flush())) {
+                std::cerr << "Error: cannot write " << write_baseline_path << ".\n";
+                return 1;
+            }
+        }
+
+    } else if (mode == "SINGLE") {
         std::string secret_header, secret_word;
         if (!(std::cin >> secret_header >> secret_word) || secret_header != "SECRET") {
             std::cerr << "Error: invalid SINGLE input (expect: SECRET <word>).\n";
@@ -206,33 +1187,110 @@ int main() {
             std::cerr << "Error: SECRET length != word_length.\n";
             return 1;
         }
-        Evaluator::evaluateSingleGame(game, solver, secret_word);
+        Evaluator::evaluateSingleGame(game, solver, secret_word, out, output_mode, trace_out.get());
 
-    } else if (mode == "BATCH") {
-        int k = 0;
-        if (!(std::cin >> k) || k < 1) {
+    } else if (mode == "BATCH" || mode == "STREAM") {
+        //BATCH gives k up front, STREAM reads secrets until end of input
+        long long k = -1;
+        if (mode == "BATCH" && (!(std::cin >> k) || k < 1)) {
             std::cerr << "Error: invalid BATCH k.\n";
             return 1;
         }
-        std::vector<std::string> secrets(k);
-        for (int i = 0; i < k; ++i) {
-            std::string secret_header;
-            if (!(std::cin >> secret_header >> secrets[i]) || secret_header != "SECRET") {
-                std::cerr << "Error: invalid BATCH secret line at GAME " << (i+1) << ".\n";
-                return 1;
+        BoundedQueue<std::vector<std::string>> secrets(16);
+        std::string read_error;
+        std::thread reader(readSecrets, std::ref(secrets), config.L, k, std::ref(read_error));
+        BatchStats stats;
+        if (interleave > 0 && config.S > 0 && policy == "lex" && game_kind == "classic") {
+            //lex on classic rules: games with the same guess and pattern share the filtering
+            stats = Evaluator::evaluateInterleaved(config, secrets, out, output_mode, interleave, shard, trace_out.get());
+        } else if (interleave > 0) {
+            //anything else: one game and one solver per slot, driven through ISolver::step()
+            std::vector<std::unique_ptr<IWordGame>> games;
+            std::vector<std::unique_ptr<ISolver>> solvers;
+            for (int s = 0; s < interleave; ++s) {
+                games.push_back(makeGame(game_kind, config));
+                solvers.push_back(findPolicy(policy)->make(config));
+                solvers.back()->setMoveBudget(std::chrono::microseconds(move_budget_us));
             }
-            if ((int)secrets[i].size() != config.L) {
-                std::cerr << "Error: SECRET length != word_length at GAME " << (i+1) << ".\n";
-                return 1;
+            stats = Evaluator::evaluateScheduled(games, solvers, secrets, out, output_mode, shard, trace_out.get());
+            for (const auto& slot_solver : solvers) slot_search += slot_solver->searchStats();
+        } else {
+            stats = Evaluator::evaluateStream(game, solver, secrets, out, output_mode, shard, trace_out.get());
+        }
+        reader.join();
+        if (!read_error.empty()) {
+            out.finish();
+            std::cerr << read_error << '\n';
+            return 1;
+        }
+        if (sharded) Evaluator::printPartial(shard, stats, output_mode, out);
+        else Evaluator::printSummary(stats, output_mode, out);
+
+    } else if (mode == "COMPARE") {
+        std::vector<PolicyRun> runs;
+        if (!parsePolicyRuns(compare_list, move_budget_us, runs)) {
+            std::cerr << "Error: bad --compare list " << compare_list << " (registered:";
+            for (const auto& entry : kPolicies) std::cerr << ' ' << entry.name;
+            std::cerr << ").\n";
+            return 1;
+        }
+        //feedback of every dictionary pair once, if it fits
+        std::unique_ptr<PatternTable> table;
+        std::string skipped = "no dictionary";
+        if (config.S > 0) {
+            SharedDictionary dict(config);
+            size_t max_bytes = table_mb >= 0 ? (size_t)table_mb << 20 : PatternTable::kDefaultMaxBytes;
+            skipped = PatternTable::skipReason(dict.size(), config.L, max_bytes);
+            if (skipped.empty()) {
+                table.reset(new PatternTable(dict, (int)std::max(1u, std::thread::hardware_concurrency())));
             }
         }
-        Evaluator::evaluateBatch(game, solver, secrets);
+        if (!table) std::cerr << "COMPARE pattern table skipped: " << skipped << '\n';
+        double prep_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - prep_start).count();
+
+        BoundedQueue<std::vector<std::string>> queue(16);
+        std::string read_error;
+        std::thread reader(readSecrets, std::ref(queue), config.L, -1LL, std::ref(read_error));
+        std::vector<std::string> secrets, chunk;
+        while (queue.pop(chunk)) secrets.insert(secrets.end(), chunk.begin(), chunk.end());
+        reader.join();
+        if (!read_error.empty()) {
+            std::cerr << read_error << '\n';
+            return 1;
+        }
+
+        auto run_start = std::chrono::steady_clock::now();
+        comparePolicies(config, game_kind, secrets, table.get(), runs);
+        double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - run_start).count();
+
+        std::ostringstream head;
+        head << "COMPARE games=" << secrets.size() << " policies=" << runs.size()
+             << " words=" << (table ? table->size() : config.S) << " pattern_table=" << (table ? "yes" : "no")
+             << std::fixed << std::setprecision(1) << " prep_ms=" << prep_ms << " wall_ms=" << wall_ms << '\n';
+        out.buffer() += head.str();
+        out.buffer() += compareTable(runs);
 
     } else {
-        std::cerr << "Error: unknown mode. Use SINGLE or BATCH.\n";
+        std::cerr << "Error: unknown mode. Use SINGLE, BATCH, STREAM, REPLAY or COMPARE.\n";
         return 1;
     }
 
+    if (move_budget_us > 0 && mode != "COMPARE") {
+        ISolver::SearchStats search = slot_search;
+        search += solver.searchStats();
+        std::cerr << "SEARCH moves=" << search.moves << " cut=" << search.cut
+                  << " scored=" << search.scored << "/" << search.total << '\n';
+    }
+    if (memory) {
+        //a game's bytes are its arena and its solver's buffers (a runner slot's for the lex fast path)
+        const ArenaTotals& totals = ArenaTotals::get();
+        long long games = totals.games.load();
+        std::cerr << "MEMORY games=" << games
+                  << " bytes_per_game_avg=" << (games > 0 ? totals.game_bytes.load() / games : 0)
+                  << " bytes_per_game_max=" << totals.max_game_bytes.load()
+                  << " arena_peak_bytes=" << totals.peak_reserved.load()
+                  << " peak_rss_kb=" << peakRssKb() << '\n';
+    }
+
     return 0;
 }
-
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <sys/resource.h>
+
+// Monotonic allocator for the state of one game: allocating just moves a pointer forward,
+// nothing is freed on its own, and release() drops the whole game in one step.
+// The blocks stay with the arena (merged into one after a game that needed several), so once
+// the first games are played a game costs no malloc at all and threads never meet in the
+// global allocator.
+
+//numbers over every arena of the process, any thread can read them
+struct ArenaTotals {
+    std::atomic<long long> games{0};//games accounted
+    std::atomic<long long> game_bytes{0};//bytes those games used, summed
+    std::atomic<long long> max_game_bytes{0};
+    std::atomic<long long> reserved{0};//bytes all arenas hold right now
+    std::atomic<long long> peak_reserved{0};
+
+    static ArenaTotals& get() {
+        static ArenaTotals totals;
+        return totals;
+    }
+
+    //one finished game that needed 'bytes'
+    static void addGame(long long bytes) {
+        ArenaTotals& totals = get();
+        totals.games.fetch_add(1, std::memory_order_relaxed);
+        totals.game_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        raise(totals.max_game_bytes, bytes);
+    }
+
+    static void raise(std::atomic<long long>& max, long long value) {
+        long long seen = max.load(std::memory_order_relaxed);
+        while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+};
+
+//peak resident memory of the whole process in KB (arenas, dictionary, buffers, everything)
+inline long peakRssKb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+class GameArena {
+public:
+    explicit GameArena(size_t block_bytes = 1024) : block_bytes_(block_bytes) {}
+    ~GameArena() {
+        account();
+        for (const Block& block : blocks_) freeBlock(block);
+    }
+    GameArena(const GameArena&) = delete;
+    GameArena& operator=(const GameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t align) {
+        size_t at = (offset_ + align - 1) & ~(align - 1);
+        if (blocks_.empty() || at + bytes > blocks_.back().size) {
+            //new block, the old ones stay valid until release(). malloc aligns for any type
+            size_t size = block_bytes_;
+            while (size < bytes) size *= 2;
+            blocks_.push_back(newBlock(size));
+            offset_ = 0;
+            at = 0;
+        }
+        used_ += at + bytes - offset_;
+        offset_ = at + bytes;
+        return blocks_.back().data + at;
+    }
+
+    //bytes handed out since the last release(), padding included
+    size_t used() const { return used_; }
+    //bytes taken from malloc
+    size_t reserved() const { return reserved_; }
+    //the game also holds 'bytes' outside the arena (its solver's buffers), account() adds them.
+    //the latest call counts, release() sets it back to 0
+    void countOutside(size_t bytes) { outside_ = bytes; }
+
+    //adds this game to ArenaTotals, once per game (the game calls it when it ends)
+    void account() {
+        if (accounted_ || used_ + outside_ == 0) return;
+        accounted_ = true;
+        ArenaTotals::addGame((long long)(used_ + outside_));
+    }
+
+    //everything allocated so far is gone, containers using it must be emptied first
+    void release() {
+        account();
+        if (blocks_.size() > 1) {
+            //the next game will likely need as much, so make it one block
+            size_t total = 0;
+            for (const Block& block : blocks_) {
+                total += block.size;
+                freeBlock(block);
+            }
+            blocks_.clear();
+            blocks_.push_back(newBlock(total));
+        }
+        offset_ = 0;
+        used_ = 0;
+        outside_ = 0;
+        accounted_ = false;
+    }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    Block newBlock(size_t size) {
+        char* data = static_cast<char*>(std::malloc(size));
+        if (!data) throw std::bad_alloc();
+        reserved_ += size;
+        ArenaTotals& totals = ArenaTotals::get();
+        long long now = totals.reserved.fetch_add((long long)size, std::memory_order_relaxed) + (long long)size;
+        ArenaTotals::raise(totals.peak_reserved, now);
+        return {data, size};
+    }
+    void freeBlock(const Block& block) {
+        std::free(block.data);
+        reserved_ -= block.size;
+        ArenaTotals::get().reserved.fetch_sub((long long)block.size, std::memory_order_relaxed);
+    }
+
+    size_t block_bytes_;
+    std::vector<Block> blocks_;
+    size_t offset_ = 0;//in the last block
+    size_t used_ = 0;
+    size_t outside_ = 0;
+    size_t reserved_ = 0;
+    bool accounted_ = false;
+};
+
+// std allocator over a GameArena, deallocate does nothing (release() frees it all)
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    GameArena* arena;
+
+    explicit ArenaAllocator(GameArena* a) : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena != b.arena; }
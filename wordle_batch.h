@@ -0,0 +1,322 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "wordle_common.h"
+
+// The dictionary shared by every game in flight.
+// Words are sorted and unique, so word index order is lexicographic order,
+// and the letters are stored back to back so a pass over them stays in cache.
+class SharedDictionary {
+public:
+    explicit SharedDictionary(const Config& cfg) : L_(cfg.L) {
+        // same words MySolver plays with: length L, letters a-z
+        for (const auto& word : cfg.dict_words) {
+            if (IWordGame::packWord(word, L_) != IWordGame::kInvalidWord) words_.push_back(word);
+        }
+        if (cfg.packed_words) {
+            for (uint64_t word : *cfg.packed_words) words_.push_back(IWordGame::unpackWord(word, L_));
+        }
+        if (cfg.embedded) {
+            for (int i = 0; i < wordle_embedded::kCount; ++i) {
+                words_.push_back(IWordGame::unpackWord(wordle_embedded::kPacked[i], L_));
+            }
+        }
+        std::sort(words_.begin(), words_.end());
+        words_.erase(std::unique(words_.begin(), words_.end()), words_.end());
+
+        letters_.resize(words_.size() * L_);
+        packed_.resize(words_.size());
+        for (size_t i = 0; i < words_.size(); ++i) {
+            std::copy(words_[i].begin(), words_[i].end(), letters_.begin() + i * L_);
+            packed_[i] = IWordGame::packWord(words_[i], L_);
+        }
+    }
+
+    int size() const { return (int)words_.size(); }
+    int length() const { return L_; }
+    const std::string& word(int i) const { return words_[i]; }
+    const char* letters(int i) const { return &letters_[(size_t)i * L_]; }
+    uint64_t packed(int i) const { return packed_[i]; }
+    const std::vector<uint64_t>& packedWords() const { return packed_; }
+
+private:
+    int L_;
+    std::vector<std::string> words_;
+    std::vector<char> letters_;
+    std::vector<uint64_t> packed_;
+};
+
+// Feedback code of every (guess, secret) pair of the dictionary, filled once and after that
+// only read, so any number of solvers on any number of threads can share it.
+// n^2 codes of 2 bytes each, so check skipReason() before building one.
+class PatternTable {
+public:
+    static constexpr size_t kDefaultMaxBytes = (size_t)64 << 20;//COMPARE's --table-mb default
+    static size_t bytesFor(int words) { return (size_t)words * words * sizeof(uint16_t); }
+    //empty if a table for 'words' words of length L fits in 'max_bytes', otherwise why not
+    static std::string skipReason(int words, int L, size_t max_bytes) {
+        if (max_bytes == 0) return "turned off (--table-mb=0)";
+        if (L > 10) return "3^" + std::to_string(L) + " patterns do not fit in 16 bits";//3^10 still does
+        size_t bytes = bytesFor(words);
+        if (bytes > max_bytes) {
+            return std::to_string(words) + " words need " + std::to_string((bytes + (1 << 20) - 1) >> 20) +
+                   " MB, the limit is " + std::to_string(max_bytes >> 20) + " MB (--table-mb)";
+        }
+        return "";
+    }
+
+    // rows are handed out round robin to 'threads' threads
+    PatternTable(const SharedDictionary& dict, int threads)
+        : n_(dict.size()), words_(dict.packedWords()), codes_((size_t)n_ * n_)
+    {
+        const int L = dict.length();
+        threads = std::max(1, std::min(threads, n_));
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([this, &dict, L, t, threads] {
+                for (int g = t; g < n_; g += threads) {
+                    uint16_t* row = &codes_[(size_t)g * n_];
+                    for (int s = 0; s < n_; ++s) {
+                        row[s] = (uint16_t)IWordGame::feedbackCode(dict.letters(s), dict.letters(g), L);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    int size() const { return n_; }
+    // the dictionary packed and sorted, positions in here are the table's word numbers
+    const std::vector<uint64_t>& words() const { return words_; }
+    // position of a packed word, -1 if it is not in the dictionary
+    int indexOf(uint64_t packed) const {
+        auto it = std::lower_bound(words_.begin(), words_.end(), packed);
+        return (it != words_.end() && *it == packed) ? (int)(it - words_.begin()) : -1;
+    }
+    // row[s] = pattern code 'guess' gets when word s is the secret
+    const uint16_t* row(int guess) const { return &codes_[(size_t)guess * n_]; }
+
+private:
+    int n_;
+    std::vector<uint64_t> words_;
+    std::vector<uint16_t> codes_;
+};
+
+// A game that left the runner, with everything the evaluator needs to print it
+struct FinishedGame {
+    long long index;//position in the input, from 1
+    std::string secret;
+    int result;//steps, or -1 if lost
+    std::vector<PackedTurn> turns;
+};
+
+// Plays many ClassicWordle games against the MySolver policy (smallest consistent word)
+// on one thread. Each game is a small state machine in a slot: pick guess, get pattern,
+// wait for filtering. tick() moves every slot one turn and then filters them by group:
+// games that played the same guess and got the same pattern need the same test on their
+// words, so feedback runs once per word of the group (the union of their candidates) and
+// the result is ANDed into each of them. Under this policy games with the same history
+// have the same candidates, so the wider the runner, the more games share each pass.
+// A group that still had the whole dictionary (the opening turn) gives the complete mask
+// of that (guess, pattern), which is kept: every later game's opening filter is then a
+// plain AND.
+class InterleavedRunner {
+public:
+    InterleavedRunner(const SharedDictionary& dict, int T, int width)
+        : dict_(dict),
+          T_(T),
+          blocks_((dict.size() + 63) / 64),
+          slots_(width < 1 ? 1 : width),
+          bits_(slots_.size() * blocks_, 0),
+          all_(blocks_, ~0ULL),
+          mask_(blocks_, 0),
+          max_masks_(blocks_ == 0 ? 0 : kMaskCacheBytes / (blocks_ * sizeof(uint64_t)))
+    {
+        int tail = dict.size() % 64;
+        if (tail != 0) all_[blocks_ - 1] = (1ULL << tail) - 1;
+        for (size_t s = 0; s < slots_.size(); ++s) {
+            slots_[s].turns.reserve(std::min(T_, IWordGame::kReservedTurns));
+            free_.push_back((int)s);
+        }
+    }
+
+    bool hasFreeSlot() const { return !free_.empty(); }
+    bool idle() const { return free_.size() == slots_.size(); }
+
+    // start a new game in a free slot, every dictionary word is a candidate
+    void add(long long index, const std::string& secret) {
+        int s = free_.back();
+        free_.pop_back();
+        Slot& slot = slots_[s];
+        slot.state = SlotState::NEED_GUESS;
+        slot.index = index;
+        slot.secret = secret;
+        slot.turns.clear();
+        slot.low_block = 0;
+        slot.fresh = true;
+
+        std::copy(all_.begin(), all_.end(), bits_.begin() + (size_t)s * blocks_);
+        if (dict_.size() == 0) slot.low_block = blocks_;
+        active_.push_back(s);
+    }
+
+    // one turn for every game in flight, games that ended are appended to 'done'
+    void tick(std::vector<FinishedGame>& done) {
+        const int L = dict_.length();
+        filtering_.clear();
+
+        // step 1: every game picks its smallest candidate and gets its pattern
+        for (size_t a = 0; a < active_.size(); ) {
+            int s = active_[a];
+            Slot& slot = slots_[s];
+            int guess = firstCandidate(s);
+            bool over = false;
+            if (guess < 0) {
+                over = true;//no candidate left, solver gives up
+            } else {
+                const std::string& word = dict_.word(guess);
+                int code = IWordGame::feedbackCode(slot.secret.c_str(), dict_.letters(guess), L);
+                slot.turns.push_back({guess, code});
+                slot.guess = guess;
+                slot.code = code;
+                over = (word == slot.secret) || ((int)slot.turns.size() >= T_);
+            }
+            if (over) {
+                finish(s, done);
+                active_[a] = active_.back();
+                active_.pop_back();
+            } else {
+                slot.state = SlotState::NEED_FILTER;
+                filtering_.push_back(s);
+                ++a;
+            }
+        }
+
+        // step 2: filter, one group per (guess, pattern)
+        std::sort(filtering_.begin(), filtering_.end(), [this](int a, int b) { return key(a) < key(b); });
+        for (size_t first = 0; first < filtering_.size(); ) {
+            size_t last = first + 1;
+            while (last < filtering_.size() && key(filtering_[last]) == key(filtering_[first])) ++last;
+            filterGroup(&filtering_[first], last - first, L);
+            first = last;
+        }
+        for (int s : filtering_) slots_[s].state = SlotState::NEED_GUESS;
+    }
+
+    // how many feedback calls the filtering made, and how many a pass per game would have made
+    long long feedbackCalls() const { return feedback_calls_; }
+    long long unsharedCalls() const { return unshared_calls_; }
+
+private:
+    enum class SlotState { FREE, NEED_GUESS, NEED_FILTER };
+
+    struct Slot {
+        SlotState state = SlotState::FREE;
+        long long index = 0;
+        std::string secret;
+        std::vector<std::pair<int, int>> turns;//(guess word index, pattern code)
+        int guess = -1;
+        int code = 0;
+        int low_block = 0;//blocks before this one are known to be empty
+        bool fresh = true;//not filtered yet, the whole dictionary
+    };
+
+    static constexpr size_t kMaskCacheBytes = (size_t)32 << 20;
+
+    uint64_t key(int s) const { return ((uint64_t)slots_[s].guess << 32) | (uint32_t)slots_[s].code; }
+
+    // keeps, in every slot of the group, the words that give the group's pattern for its guess
+    void filterGroup(const int* group, size_t count, int L) {
+        const Slot& lead = slots_[group[0]];
+        const uint64_t* mask;
+        auto cached = masks_.find(key(group[0]));
+        if (cached != masks_.end()) {
+            mask = cached->second.data();
+        } else {
+            bool complete = false;
+            int low = blocks_;
+            for (size_t i = 0; i < count; ++i) {
+                complete = complete || slots_[group[i]].fresh;
+                low = std::min(low, slots_[group[i]].low_block);
+            }
+            if (complete) low = 0;
+            const char* guess = dict_.letters(lead.guess);
+            std::fill(mask_.begin(), mask_.begin() + low, 0);
+            for (int b = low; b < blocks_; ++b) {
+                uint64_t m = 0;//words of this block any slot of the group still has
+                if (complete) {
+                    m = all_[b];
+                } else {
+                    for (size_t i = 0; i < count; ++i) m |= bits_[(size_t)group[i] * blocks_ + b];
+                }
+                uint64_t keep = 0;
+                while (m) {
+                    int bit = __builtin_ctzll(m);
+                    m &= m - 1;
+                    ++feedback_calls_;
+                    if (IWordGame::feedbackCode(dict_.letters(b * 64 + bit), guess, L) == lead.code) {
+                        keep |= 1ULL << bit;
+                    }
+                }
+                mask_[b] = keep;
+            }
+            if (complete && masks_.size() < max_masks_) masks_.emplace(key(group[0]), mask_);
+            mask = mask_.data();
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Slot& slot = slots_[group[i]];
+            uint64_t* bits = &bits_[(size_t)group[i] * blocks_];
+            for (int b = slot.low_block; b < blocks_; ++b) {
+                unshared_calls_ += __builtin_popcountll(bits[b]);
+                bits[b] &= mask[b];
+            }
+            slot.fresh = false;
+        }
+    }
+
+    int firstCandidate(int s) {
+        Slot& slot = slots_[s];
+        const uint64_t* bits = &bits_[(size_t)s * blocks_];
+        while (slot.low_block < blocks_ && bits[slot.low_block] == 0) ++slot.low_block;
+        if (slot.low_block == blocks_) return -1;
+        return slot.low_block * 64 + __builtin_ctzll(bits[slot.low_block]);
+    }
+
+    void finish(int s, std::vector<FinishedGame>& done) {
+        Slot& slot = slots_[s];
+        //what this game held in its slot: the candidate bitmap, its turns and its secret
+        ArenaTotals::addGame((long long)(blocks_ * sizeof(uint64_t) + slot.turns.capacity() * sizeof(slot.turns[0]) +
+                                         sizeof(Slot) + slot.secret.size()));
+        FinishedGame game;
+        game.index = slot.index;
+        game.secret = slot.secret;
+        bool won = !slot.turns.empty() && dict_.word(slot.turns.back().first) == slot.secret;
+        game.result = won ? (int)slot.turns.size() : -1;
+        for (const auto& turn : slot.turns) {
+            game.turns.push_back({dict_.packed(turn.first), turn.second});
+        }
+        done.push_back(std::move(game));
+        slot.state = SlotState::FREE;
+        free_.push_back(s);
+    }
+
+    const SharedDictionary& dict_;
+    int T_;
+    int blocks_;
+    std::vector<Slot> slots_;
+    std::vector<uint64_t> bits_;//candidate bitmap per slot, 'blocks_' words each
+    std::vector<uint64_t> all_;//the whole dictionary as a bitmap
+    std::vector<uint64_t> mask_;//scratch for filterGroup
+    //complete masks of the (guess, pattern) pairs seen on opening turns, by key()
+    std::unordered_map<uint64_t, std::vector<uint64_t>> masks_;
+    size_t max_masks_;
+    long long feedback_calls_ = 0;
+    long long unshared_calls_ = 0;
+    std::vector<int> free_;
+    std::vector<int> active_;
+    std::vector<int> filtering_;
+};
@@ -8,6 +8,10 @@
 #include <iostream>
 #include <memory>
 #include <algorithm> // Required for std::max
+#include <cstdint>
+#include <limits>
+#include "wordle_arena.h"
+#include "wordle_embedded.h"
 
 
 
@@ -16,6 +20,19 @@ struct HistoryEntry {
     std::string guess;
     std::string pattern;
 };
+//same turn, packed: guess as IWordGame::packWord, pattern as IWordGame::encodePattern
+struct PackedTurn {
+    uint64_t guess;
+    int pattern;
+};
+//the turns of one game live in the game's arena (wordle_arena.h)
+using TurnList = std::vector<PackedTurn, ArenaAllocator<PackedTurn>>;
+//what makeGuess reports instead of throwing on the hot path
+enum class GuessStatus {
+    OK,
+    NOT_PLAYING,//game not started or already over
+    INVALID_GUESS//the game mode does not allow this guess
+};
 //state machine, keep track of where we are 
 enum class GameState {
     NOT_STARTED,//game object created but secret not set
@@ -29,6 +46,321 @@ struct Config {
     int T;//max tries
     int S;//dictionary size
     std::vector<std::string> dict_words;//list of allowed words
+    bool embedded = false;//words come from wordle_embedded.h instead, dict_words stays empty
+    //the words packed, sorted and unique, made once and shared by many games and solvers
+    //(COMPARE mode), dict_words stays empty then
+    std::shared_ptr<const std::vector<uint64_t>> packed_words;
+};
+
+// Inverted index over a word list, used to count the words that fit a history
+// without running feedback on every one of them.
+//  - one bitmap per (position, letter): words with that letter there
+//  - one bitmap per (letter, k): words with at least k copies of that letter
+// A (guess, pattern) turn then becomes a few ANDs / AND-NOTs of these bitmaps:
+//  G at i    -> letter at i                 Y/B at i -> not that letter at i
+//  letter with n G/Y marks -> at least n copies, and if it also got a B -> not n+1 copies
+// which is exactly the set of words that would give that pattern.
+class WordIndex {
+public:
+    template <typename Words>
+    WordIndex(const Words& words, int L)
+        : L_(L),
+          blocks_((words.size() + 63) / 64),
+          words_(words.size()),
+          pos_letter_((size_t)L * 26 * blocks_, 0),
+          letter_min_((size_t)26 * L * blocks_, 0)
+    {
+        size_t w = 0;
+        for (const auto& word : words) {
+            uint64_t bit = 1ULL << (w % 64);
+            size_t block = w / 64;
+            int counts[26] = {0};
+            for (int i = 0; i < L_ && i < (int)word.size(); ++i) {
+                int c = word[i] - 'a';
+                if (c < 0 || c >= 26) continue;
+                pos_letter_[((size_t)i * 26 + c) * blocks_ + block] |= bit;
+                counts[c]++;
+            }
+            for (int c = 0; c < 26; ++c) {
+                for (int k = 1; k <= counts[c]; ++k) {
+                    letter_min_[((size_t)c * L_ + (k - 1)) * blocks_ + block] |= bit;
+                }
+            }
+            ++w;
+        }
+    }
+
+    // same index straight from packed words and their letter counts (the embedded dictionary)
+    WordIndex(const uint64_t* packed, const unsigned char (*counts)[26], int n, int L)
+        : L_(L),
+          blocks_((n + 63) / 64),
+          words_(n),
+          pos_letter_((size_t)L * 26 * blocks_, 0),
+          letter_min_((size_t)26 * L * blocks_, 0)
+    {
+        for (int w = 0; w < n; ++w) {
+            uint64_t bit = 1ULL << (w % 64);
+            size_t block = w / 64;
+            uint64_t word = packed[w];
+            for (int i = L_ - 1; i >= 0; --i, word >>= 5) {
+                pos_letter_[((size_t)i * 26 + (word & 31) - 1) * blocks_ + block] |= bit;
+            }
+            for (int c = 0; c < 26; ++c) {
+                for (int k = 1; k <= counts[w][c]; ++k) {
+                    letter_min_[((size_t)c * L_ + (k - 1)) * blocks_ + block] |= bit;
+                }
+            }
+        }
+    }
+
+    // how many words fit every turn (guess packed, pattern as base 3 code)
+    int countConsistent(const TurnList& turns) const {
+        std::vector<uint64_t> bits(blocks_, ~0ULL);
+        if (words_ % 64 != 0) bits[blocks_ - 1] = (1ULL << (words_ % 64)) - 1;
+        for (const auto& turn : turns) {
+            if (!applyTurn(turn, bits)) return 0;
+        }
+        int count = 0;
+        for (uint64_t b : bits) count += __builtin_popcountll(b);
+        return count;
+    }
+
+private:
+    // keeps only the words in 'bits' that give turn.pattern for turn.guess,
+    // false if no word at all can give that pattern
+    bool applyTurn(const PackedTurn& turn, std::vector<uint64_t>& bits) const {
+        int letters[32], digits[32];
+        uint64_t guess = turn.guess;
+        int code = turn.pattern;
+        for (int i = L_ - 1; i >= 0; --i) {
+            letters[i] = (int)(guess & 31) - 1;
+            guess >>= 5;
+            digits[i] = code % 3;//2 = G, 1 = Y, 0 = B
+            code /= 3;
+        }
+
+        int marked[26] = {0};//G and Y per letter
+        bool black[26] = {false};
+        for (int i = 0; i < L_; ++i) {
+            int c = letters[i];
+            if (digits[i] == 2) {
+                andWith(bits, posLetter(i, c));
+                marked[c]++;
+            } else {
+                andNot(bits, posLetter(i, c));
+                if (digits[i] == 1) {
+                    // yellows are handed out left to right, so a Y after a B of the same letter never happens
+                    if (black[c]) return false;
+                    marked[c]++;
+                } else {
+                    black[c] = true;
+                }
+            }
+        }
+        for (int c = 0; c < 26; ++c) {
+            if (marked[c] > 0) andWith(bits, atLeast(c, marked[c]));
+            if (black[c] && marked[c] < L_) andNot(bits, atLeast(c, marked[c] + 1));
+        }
+        return true;
+    }
+
+    const uint64_t* posLetter(int pos, int letter) const {
+        return &pos_letter_[((size_t)pos * 26 + letter) * blocks_];
+    }
+    const uint64_t* atLeast(int letter, int k) const {
+        return &letter_min_[((size_t)letter * L_ + (k - 1)) * blocks_];
+    }
+    void andWith(std::vector<uint64_t>& bits, const uint64_t* other) const {
+        for (size_t b = 0; b < blocks_; ++b) bits[b] &= other[b];
+    }
+    void andNot(std::vector<uint64_t>& bits, const uint64_t* other) const {
+        for (size_t b = 0; b < blocks_; ++b) bits[b] &= ~other[b];
+    }
+
+    int L_;
+    size_t blocks_;
+    size_t words_;
+    std::vector<uint64_t> pos_letter_;
+    std::vector<uint64_t> letter_min_;
+};
+
+// Universe mode (S == 0): every a-z string of length L is a word, far too many to list.
+// Instead the history is boiled down to constraints:
+//  - a fixed letter per position (G) and letters banned per position (Y/B)
+//  - at least / at most how many copies of each letter
+// A word meets them exactly when it gives the recorded pattern for every turn,
+// so the smallest such word is what a full candidate list would start with.
+// Works for words up to kMaxLength letters.
+class UniverseConstraints {
+public:
+    static constexpr int kMaxLength = 32;
+    // most DP states count() will allocate (two tables of this many long longs, 16 MB)
+    static constexpr long long kMaxCountStates = 1 << 20;
+
+    explicit UniverseConstraints(int L) { reset(L); }
+
+    void reset(int L) {
+        L_ = L;
+        possible_ = true;
+        for (int i = 0; i < kMaxLength; ++i) { fixed_[i] = -1; banned_[i] = 0; }
+        for (int c = 0; c < 26; ++c) { min_[c] = 0; max_[c] = L; }
+    }
+
+    // one turn: guess as IWordGame::packWord, pattern as IWordGame::encodePattern
+    void add(uint64_t guess, int pattern) {
+        int letters[kMaxLength], digits[kMaxLength];
+        for (int i = L_ - 1; i >= 0; --i) {
+            letters[i] = (int)(guess & 31) - 1;
+            guess >>= 5;
+            digits[i] = pattern % 3;//2 = G, 1 = Y, 0 = B
+            pattern /= 3;
+        }
+        addTurn(letters, digits);
+    }
+    // same with strings, for words too long to pack
+    void add(const std::string& guess, const std::string& pattern) {
+        int letters[kMaxLength], digits[kMaxLength];
+        for (int i = 0; i < L_; ++i) {
+            letters[i] = guess[i] - 'a';
+            digits[i] = pattern[i] == 'G' ? 2 : (pattern[i] == 'Y' ? 1 : 0);
+        }
+        addTurn(letters, digits);
+    }
+
+    // lexicographically smallest word that fits, written into out[0..L-1]; false if none
+    bool smallest(char* out) const {
+        if (!possible_) return false;
+        int counts[26] = {0};
+        return search(0, out, counts);
+    }
+
+    // how many words fit, exact up to 13 letters (26^13 still fits), longer universes saturate at LLONG_MAX.
+    // DP over positions instead of walking the words: the state is how many copies of each letter
+    // with a minimum are placed so far, stopped at the minimum (a letter with a B has max == min,
+    // any other has no max that matters). Letters no turn mentioned behave alike, so they are one pool.
+    // The states multiply up as prod(min + 1): 13 letters make at most 2^13 of them, but a long
+    // universe can need hundreds of millions, so above kMaxCountStates it returns -1 (not counted).
+    long long count() const {
+        if (!possible_) return 0;
+        int stride[26];
+        long long states = 1;
+        int need = 0;
+        uint32_t mentioned = 0;
+        for (int c = 0; c < 26; ++c) {
+            stride[c] = (int)states;
+            if (min_[c] > 0) {
+                states = std::min(states * (min_[c] + 1), kMaxCountStates + 1);
+                need += min_[c];
+            }
+            if (min_[c] > 0 || max_[c] < L_) mentioned |= 1u << c;
+        }
+        if (need > L_) return 0;
+        if (states > kMaxCountStates) return -1;
+        for (int i = 0; i < L_; ++i) mentioned |= banned_[i];
+        long long pool = 0;
+        for (int c = 0; c < 26; ++c) pool += !(mentioned >> c & 1);
+
+        std::vector<long long> ways(states, 0), next(states);
+        ways[0] = 1;
+        for (int i = 0; i < L_; ++i) {
+            std::fill(next.begin(), next.end(), 0);
+            for (int s = 0; s < states; ++s) {
+                if (ways[s] == 0) continue;
+                if (fixed_[i] < 0) next[s] = addCapped(next[s], mulCapped(ways[s], pool));
+                for (int c = 0; c < 26; ++c) {
+                    if (!(mentioned >> c & 1)) continue;
+                    if (fixed_[i] >= 0 ? c != fixed_[i] : (banned_[i] >> c & 1)) continue;
+                    int have = min_[c] > 0 ? s / stride[c] % (min_[c] + 1) : 0;
+                    if (have + 1 > max_[c]) continue;
+                    int to = have < min_[c] ? s + stride[c] : s;
+                    next[to] = addCapped(next[to], ways[s]);
+                }
+            }
+            ways.swap(next);
+        }
+        return ways[states - 1];//every letter at its minimum
+    }
+
+private:
+    // letters 0..25, digits 2 = G, 1 = Y, 0 = B
+    void addTurn(const int* letters, const int* digits) {
+        int marked[26] = {0};
+        bool black[26] = {false};
+        for (int i = 0; i < L_; ++i) {
+            int c = letters[i];
+            if (digits[i] == 2) {
+                if (fixed_[i] >= 0 && fixed_[i] != c) possible_ = false;
+                fixed_[i] = c;
+                marked[c]++;
+            } else {
+                banned_[i] |= 1u << c;
+                if (digits[i] == 1) {
+                    if (black[c]) possible_ = false;//a Y after a B of the same letter never happens
+                    marked[c]++;
+                } else {
+                    black[c] = true;
+                }
+            }
+        }
+        for (int c = 0; c < 26; ++c) {
+            min_[c] = std::max(min_[c], marked[c]);
+            if (black[c]) max_[c] = std::min(max_[c], marked[c]);
+            if (min_[c] > max_[c]) possible_ = false;
+        }
+        for (int i = 0; i < L_; ++i) {
+            if (fixed_[i] >= 0 && (banned_[i] >> fixed_[i] & 1)) possible_ = false;
+        }
+    }
+
+    // depth first over positions, letters in alphabetical order, so the first word found
+    // is the smallest. Branches that can no longer reach the letter minimums are cut.
+    bool search(int pos, char* word, int* counts) const {
+        if (pos == L_) return true;
+        for (int c = 0; c < 26; ++c) {
+            if (fixed_[pos] >= 0 ? c != fixed_[pos] : (banned_[pos] >> c & 1)) continue;
+            if (counts[c] + 1 > max_[c]) continue;
+            counts[c]++;
+            if (canFinish(pos + 1, counts)) {
+                word[pos] = (char)('a' + c);
+                if (search(pos + 1, word, counts)) {
+                    counts[c]--;
+                    return true;
+                }
+            }
+            counts[c]--;
+        }
+        return false;
+    }
+
+    static long long addCapped(long long a, long long b) {
+        return a > std::numeric_limits<long long>::max() - b ? std::numeric_limits<long long>::max() : a + b;
+    }
+    static long long mulCapped(long long a, long long b) {
+        return b != 0 && a > std::numeric_limits<long long>::max() / b ? std::numeric_limits<long long>::max() : a * b;
+    }
+
+    // are there enough free positions after 'pos' for every letter still below its minimum?
+    bool canFinish(int pos, const int* counts) const {
+        int need = 0;
+        for (int c = 0; c < 26; ++c) {
+            int missing = min_[c] - counts[c];
+            if (missing <= 0) continue;
+            need += missing;
+            int room = 0;
+            for (int i = pos; i < L_; ++i) {
+                if (fixed_[i] >= 0 ? fixed_[i] == c : !(banned_[i] >> c & 1)) ++room;
+            }
+            if (room < missing) return false;
+        }
+        return need <= L_ - pos;
+    }
+
+    int L_;
+    bool possible_;
+    int fixed_[kMaxLength];
+    uint32_t banned_[kMaxLength];
+    int min_[26];
+    int max_[26];
 };
 
 class IWordGame {
@@ -36,42 +368,144 @@ public:
 //static so  can use it without creating a game obj
 // calculates the g/b/y string 
     static std::string feedback(const std::string& secret, const std::string& guess);
+// turns a G/Y/B string into a base 3 number (B=0, Y=1, G=2, first letter is the highest digit)
+// fits in 16 bits for words up to 10 letters
+    static int encodePattern(const std::string& pattern) {
+        int code = 0;
+        for (char c : pattern) {
+            code = code * 3 + (c == 'G' ? 2 : (c == 'Y' ? 1 : 0));
+        }
+        return code;
+    }
+// 5 bits per letter ('a' = 1 ... 'z' = 26), first letter in the highest bits,
+// so for words of the same length packed order == alphabetical order
+    static constexpr int kMaxPackedLength = 12;
+// turns reserved up front per game: T comes from the input and can be huge, longer games
+// grow the list in the arena (release() keeps the blocks, so that is paid once)
+    static constexpr int kReservedTurns = 64;
+    static constexpr uint64_t kInvalidWord = ~0ULL;
+// length L and letters a-z, for any L (packWord also needs L <= kMaxPackedLength)
+    static bool isLetters(const std::string& w, int L) {
+        if ((int)w.length() != L) return false;
+        for (char c : w) {
+            if (c < 'a' || c > 'z') return false;
+        }
+        return true;
+    }
+// kInvalidWord if the length is wrong or a letter is not a-z
+    static uint64_t packWord(const std::string& w, int L) {
+        if ((int)w.length() != L || L > kMaxPackedLength) return kInvalidWord;
+        uint64_t packed = 0;
+        for (char c : w) {
+            if (c < 'a' || c > 'z') return kInvalidWord;
+            packed = (packed << 5) | (uint64_t)(c - 'a' + 1);
+        }
+        return packed;
+    }
+// writes the L letters of a packed word into 'out' (no allocation)
+    static void unpackWord(uint64_t packed, int L, char* out) {
+        for (int i = L - 1; i >= 0; --i) {
+            out[i] = (char)('a' + (int)(packed & 31) - 1);
+            packed >>= 5;
+        }
+    }
+    static std::string unpackWord(uint64_t packed, int L) {
+        std::string w(L, 'a');
+        unpackWord(packed, L, &w[0]);
+        return w;
+    }
+// feedback() without any allocation, returns the encodePattern code
+    static int feedbackCode(const char* secret, const char* guess, int L) {
+        int counts[256] = {0};
+        for (int i = 0; i < L; ++i) {
+            if (secret[i] != guess[i]) counts[(unsigned char)secret[i]]++;
+        }
+        int code = 0;
+        for (int i = 0; i < L; ++i) {
+            int digit = 0;
+            if (secret[i] == guess[i]) {
+                digit = 2;
+            } else if (counts[(unsigned char)guess[i]] > 0) {
+                digit = 1;
+                counts[(unsigned char)guess[i]]--;
+            }
+            code = code * 3 + digit;
+        }
+        return code;
+    }
+    static int feedbackCode(uint64_t secret, uint64_t guess, int L) {
+        char s[kMaxPackedLength], g[kMaxPackedLength];
+        unpackWord(secret, L, s);
+        unpackWord(guess, L, g);
+        return feedbackCode(s, g, L);
+    }
+// back from the base 3 number to the G/Y/B string
+    static void decodePattern(int code, int L, char* out) {
+        for (int i = L - 1; i >= 0; --i) {
+            int digit = code % 3;
+            out[i] = (digit == 2 ? 'G' : (digit == 1 ? 'Y' : 'B'));
+            code /= 3;
+        }
+    }
+    static std::string decodePattern(int code, int L) {
+        std::string pattern(L, 'B');
+        decodePattern(code, L, &pattern[0]);
+        return pattern;
+    }
 
 protected:
 /// Variables available to children classes (Trivial/Classic/Hard)
     Config config_;
     std::string secret_;
-    std::vector<HistoryEntry> history_;
+    //owns everything below that belongs to the current game, dropped at once by start()
+    GameArena arena_;
+    //every turn of this game, room for kReservedTurns up front so playing never allocates
+    TurnList turns_;
+    //string copy of turns_, only built when someone calls getHistory() (for long words, the turns themselves).
+    //An ordinary vector, not in the arena, so getHistory() keeps its std::vector type; start() only
+    //clears it, the capacity stays for the next game
+    mutable std::vector<HistoryEntry> history_;
     GameState state_;
     int current_round_;
     bool is_universe_;
+    // L > kMaxPackedLength: words do not fit in 64 bits, so the game runs on strings only.
+    // makeGuess() keeps the turns in history_ directly, turns_ stays empty and play() refuses
+    bool long_words_;
     // The set of all allowed words. Using a 'set' makes searching very fast.
     std::set<std::string> dictionary_;
+    // built the first time getRemainingWords needs it
+    mutable std::unique_ptr<WordIndex> index_;
+    // dictionary lookup, in universe mode any a-z word of length L
+    bool inDictionary(const std::string& w) const {
+        if (config_.embedded) return wordle_embedded::contains(packWord(w, config_.L));
+        if (config_.packed_words) {
+            return std::binary_search(config_.packed_words->begin(), config_.packed_words->end(), packWord(w, config_.L));
+        }
+        if (!is_universe_) return dictionary_.find(w) != dictionary_.end();
+        return isLetters(w, config_.L);
+    }
     //check if game ends after a guess
-    void updateGameState(const std::string& last_guess) {
-        if (last_guess == secret_) {
+    void updateGameState(const char* last_guess) {
+        if (secret_.compare(0, std::string::npos, last_guess, config_.L) == 0) {
             state_ = GameState::WON;
+            arena_.account();
         } else if (current_round_ >= config_.T) {
             state_ = GameState::LOST;
+            arena_.account();
         }
     }
 
-private:
- // Helper function ,recursion
- //pos tells which letter we are currently trying to decide.
-    void generateAllWords(std::string& current, int pos);
-
 protected:
 // Fills the 'dictionary_' set
     void buildDictionary() {
         dictionary_.clear();
-        is_universe_ = (config_.S == 0);// If S is 0, we use ALL strings
+        is_universe_ = (config_.S == 0) && !config_.embedded && !config_.packed_words;// If S is 0, we use ALL strings
 
-        if (is_universe_) {
-            // Create a starting string like "aaaa"
-            std::string temp(config_.L, 'a');
-            // Recursively generate every combination 26^L words
-            generateAllWords(temp, 0);
+        if (config_.embedded || config_.packed_words) {
+            // already sorted and packed: nothing to build, inDictionary() binary searches it
+        } else if (is_universe_) {
+            // All 26^L strings are words. They are never listed (26^10 would not fit anywhere),
+            // inDictionary() checks the letters and getRemainingWords() counts with UniverseConstraints
         } else {//run when S greater 0
             // Normal mode: Copy words from input to our set, filtering by length
             for (const auto& word : config_.dict_words) {
@@ -86,12 +520,23 @@ public:
 //constructer that sets up the game based on config
     explicit IWordGame(const Config& cfg)
         : config_(cfg),
+          turns_(ArenaAllocator<PackedTurn>(&arena_)),
           state_(GameState::NOT_STARTED),
-          current_round_(0)
+          current_round_(0),
+          long_words_(cfg.L > kMaxPackedLength)
     {
         if (config_.L <= 0 || config_.T <= 0) {
             throw std::invalid_argument("Config L and T must be positive");
         }
+        if (long_words_ && (config_.embedded || config_.packed_words)) {
+            throw std::invalid_argument("Packed dictionaries need L of at most 12");
+        }
+        if (long_words_ && config_.S == 0 && config_.L > UniverseConstraints::kMaxLength) {
+            throw std::invalid_argument("Config L must be at most 32 without a dictionary");
+        }
+        if (config_.embedded && (!wordle_embedded::kAvailable || config_.L != wordle_embedded::kLength)) {
+            throw std::invalid_argument("Config L does not match the embedded dictionary");
+        }
         buildDictionary();//prepare the word list immediately
     }
     // Virtual Destructor: Essential when using inheritance so memory is cleaned up correctly
@@ -102,37 +547,61 @@ public:
     // Pure virtuals to be implemented by subclasses(trival/class/hard)
     virtual bool isValidWord(const std::string& w) const = 0;
     virtual bool isValidGuess(const std::string& guess) const = 0;
+    // packed version used by play(), children can override it to skip the unpacking
+    virtual bool isValidPackedGuess(uint64_t guess) const {
+        char letters[kMaxPackedLength];
+        unpackWord(guess, config_.L, letters);
+        return isValidGuess(std::string(letters, config_.L));//short string, no heap
+    }
     
     // Calculates how many words in the dictionary are still possible answers
-    int getRemainingWords() const; 
+    // (long long: a universe of 26^L strings does not fit in an int; -1 if a long universe is too big to count)
+    long long getRemainingWords() const;
     // Starts a new round
     void start(const std::string& secret) {
         secret_ = secret;
+        //the last game goes in one step: empty the list, then drop the arena under it
+        turns_ = TurnList(ArenaAllocator<PackedTurn>(&arena_));
+        arena_.release();
         history_.clear();
+        turns_.reserve(std::min(config_.T, kReservedTurns));
         current_round_ = 0;
         state_ = GameState::PLAYING;
     }
-    //main gameplay function
-
-    std::string makeGuess(const std::string& guess) {
+    //main gameplay function, hot path: no exceptions, no allocation
+    //on OK 'pattern' gets the encodePattern code of the feedback
+    GuessStatus play(uint64_t guess, int& pattern) {
         //check if we can play
-        if (state_ != GameState::PLAYING) {
-            throw std::invalid_argument("Invalid gamestate");
-        }
+        if (state_ != GameState::PLAYING) return GuessStatus::NOT_PLAYING;
+        if (long_words_) return GuessStatus::INVALID_GUESS;//no packed word is that long
         //Ask the specific child class: "Is this guess allowed?
-        if (!isValidGuess(guess)) {
-            throw std::invalid_argument("Invalid guess: " + guess);
-        }
-        //calculate colours
+        if (guess == kInvalidWord || !isValidPackedGuess(guess)) return GuessStatus::INVALID_GUESS;
 
-        std::string pattern = feedback(secret_, guess);
+        //calculate colours
+        char letters[kMaxPackedLength];
+        unpackWord(guess, config_.L, letters);
+        pattern = feedbackCode(secret_.c_str(), letters, config_.L);
         //save history
-        history_.push_back({guess, pattern});
+        turns_.push_back({guess, pattern});
 
         current_round_++;
         //check win or loss
-        updateGameState(guess);
-        return pattern;
+        updateGameState(letters);
+        return GuessStatus::OK;
+    }
+
+    //same as play() with strings, throws std::invalid_argument when the guess is refused
+    std::string makeGuess(const std::string& guess) {
+        if (long_words_) return makeLongGuess(guess);
+        int pattern = 0;
+        GuessStatus status = play(packWord(guess, config_.L), pattern);
+        if (status == GuessStatus::NOT_PLAYING) {
+            throw std::invalid_argument("Invalid gamestate");
+        }
+        if (status == GuessStatus::INVALID_GUESS) {
+            throw std::invalid_argument("Invalid guess: " + guess);
+        }
+        return decodePattern(pattern, config_.L);
     }
     // --- Game state queries ---
 
@@ -160,70 +629,112 @@ public:
         std::cout << current_round_ << " " << getRemainingWords() << std::endl;
     }
     //get game history
+    const TurnList& getTurns() const { return turns_; }
+
+    //Strings of every turn so far. The copy is made here on demand, so although the method is
+    //const it writes the game: like play(), only one thread at a time may use a game (the
+    //evaluators give every thread its own). The reference is valid until the next turn or start().
+    const std::vector<HistoryEntry>& getHistory() const {
+        for (size_t i = history_.size(); i < turns_.size(); ++i) {
+            history_.push_back({unpackWord(turns_[i].guess, config_.L), decodePattern(turns_[i].pattern, config_.L)});
+        }
+        return history_;
+    }
+    //bytes the current game took from its arena so far (its turns)
+    size_t memoryUsed() const { return arena_.used(); }
+    //the solver playing this game holds 'bytes' of per-game buffers, they are accounted with the game
+    void countSolverMemory(size_t bytes) { arena_.countOutside(bytes); }
 
-    const std::vector<HistoryEntry>& getHistory() const { return history_; }
+private:
+    //makeGuess() for words longer than kMaxPackedLength, all on strings
+    std::string makeLongGuess(const std::string& guess) {
+        if (state_ != GameState::PLAYING) {
+            throw std::invalid_argument("Invalid gamestate");
+        }
+        if (!isValidGuess(guess)) {
+            throw std::invalid_argument("Invalid guess: " + guess);
+        }
+        std::string pattern = feedback(secret_, guess);
+        history_.push_back({guess, pattern});
+        current_round_++;
+        updateGameState(guess.c_str());
+        return pattern;
+    }
 };
 
 // --- [Implementations of Shared/Base Methods] ---
 
-void IWordGame::generateAllWords(std::string& current, int pos) {
-    //TODO:implementation
-    // Base case: if we filled the string, insert it
-    if (pos == config_.L) {
-        dictionary_.insert(current);
-        return;
-    }
-    // Recursive step: try 'a' through 'z' at current position
-    for (char c = 'a'; c <= 'z'; ++c) {
-        current[pos] = c;
-        generateAllWords(current, pos + 1);
+// Counts how many words in the dictionary are still possible secrets.
+// Guesses need not be dictionary words (TrivialWordle), so instead of a table per guess
+// this goes through the inverted index: a few bitmap passes per turn, whatever the guess.
+long long IWordGame::getRemainingWords() const {
+    if (is_universe_) {
+        // counted from the constraints, the strings are never listed
+        UniverseConstraints constraints(config_.L);
+        if (long_words_) {
+            for (const auto& entry : history_) constraints.add(entry.guess, entry.pattern);
+        } else {
+            for (const auto& turn : turns_) constraints.add(turn.guess, turn.pattern);
+        }
+        return constraints.count();
     }
-}
-
-// Counts how many words in the dictionary are still possible secrets
-int IWordGame::getRemainingWords() const {
-    int count = 0;
-    // Check every word in the dictionary
-    for (const auto& candidate : dictionary_) {
-        bool possible = true;
-        // Does this candidate match the feedback history?
-        for (const auto& entry : history_) {
-            // If 'candidate' was the secret, would 'entry.guess' produce 'entry.pattern'?
-            if (feedback(candidate, entry.guess) != entry.pattern) {
-                possible = false;
-                break;
+    if (long_words_) {
+        // no packed index for long words, check every word against every turn
+        long long count = 0;
+        for (const auto& word : dictionary_) {
+            bool consistent = true;
+            for (const auto& entry : history_) {
+                if (feedback(word, entry.guess) != entry.pattern) { consistent = false; break; }
             }
+            if (consistent) count++;
         }
-        if (possible) {
-            count++;
+        return count;
+    }
+    if (config_.embedded) {
+        if (turns_.empty()) return wordle_embedded::kCount;
+        if (!index_) {
+            index_.reset(new WordIndex(wordle_embedded::kPacked, wordle_embedded::kLetterCounts,
+                                       wordle_embedded::kCount, config_.L));
         }
+        return index_->countConsistent(turns_);
     }
-    return count;
+    if (config_.packed_words) {
+        if (turns_.empty()) return (int)config_.packed_words->size();
+        if (!index_) {
+            std::vector<std::string> words;
+            for (uint64_t w : *config_.packed_words) words.push_back(unpackWord(w, config_.L));
+            index_.reset(new WordIndex(words, config_.L));
+        }
+        return index_->countConsistent(turns_);
+    }
+    if (turns_.empty()) return (int)dictionary_.size();
+    if (!index_) index_.reset(new WordIndex(dictionary_, config_.L));
+    return index_->countConsistent(turns_);
 }
 
 std::string IWordGame::feedback(const std::string& secret, const std::string& guess) {
     std::string result(secret.length(), 'B');
-    std::map<char, int> secret_counts;
+    int secret_counts[256] = {0};//per char, no map nodes
 
     // Count frequencies in secret
     for (char c : secret) {
-        secret_counts[c]++;
+        secret_counts[(unsigned char)c]++;
     }
 
     // Pass 1: Identify Greens (Exact matches)
     for (size_t i = 0; i < secret.length(); ++i) {
         if (guess[i] == secret[i]) {
             result[i] = 'G';
-            secret_counts[guess[i]]--;
+            secret_counts[(unsigned char)guess[i]]--;
         }
     }
 
     // Pass 2: Identify Yellows (Wrong position) vs Blacks
     for (size_t i = 0; i < secret.length(); ++i) {
         if (result[i] != 'G') { // Skip already marked greens
-            if (secret_counts[guess[i]] > 0) {
+            if (secret_counts[(unsigned char)guess[i]] > 0) {
                 result[i] = 'Y';
-                secret_counts[guess[i]]--;
+                secret_counts[(unsigned char)guess[i]]--;
             }
             // Else remains 'B' (Black)
         }
@@ -261,7 +772,7 @@ public:
     // Must be found in dictionary
     bool isValidWord(const std::string& w) const override {
         //Return true if the word was found
-        return dictionary_.find(w) != dictionary_.end();
+        return inDictionary(w);
     }
 
     bool isValidGuess(const std::string& guess) const override {
@@ -276,7 +787,7 @@ public:
 
     bool isValidWord(const std::string& w) const override {
         //must be real word
-        return dictionary_.find(w) != dictionary_.end();
+        return inDictionary(w);
     }
 
     bool isValidGuess(const std::string& guess) const override {
@@ -284,18 +795,27 @@ public:
         // We call our own isValidWord function to check this first.
         // If it fails, we immediately return false.
         if (!isValidWord(guess)) return false;
+        if (long_words_) {
+            // too long to pack, the turns are strings in history_
+            for (const auto& entry : history_) {
+                if (feedback(guess, entry.guess) != entry.pattern) return false;
+            }
+            return true;
+        }
         // If we pretend the current 'guess' is the secret
         // Compare it against every previous guess 
         // Does 'guess' generate the SAME colors for the old guesses that the real secret 
-        for (const auto& entry : history_) {
+        for (const auto& turn : turns_) {
             // This is the simulation step. We pretend the new 'guess' IS the secret word.
             // Then we ask: what feedback would this fake secret ('guess') give for our
-            // OLD guess ('entry.guess')?
-            std::string projected_feedback = feedback(guess, entry.guess);
+            // OLD guess ('turn.guess')?
+            char old_guess[kMaxPackedLength];
+            unpackWord(turn.guess, config_.L, old_guess);
+            int projected_feedback = feedbackCode(guess.c_str(), old_guess, config_.L);
             // Now we compare. If the feedback we just simulated ('projected_feedback')
-            // is NOT THE SAME as the feedback we ACTUALLY got on that past turn ('entry.pattern'),
+            // is NOT THE SAME as the feedback we ACTUALLY got on that past turn ('turn.pattern'),
             // it means this new guess is illogical and contradicts the clues.
-            if (projected_feedback != entry.pattern) {
+            if (projected_feedback != turn.pattern) {
                 return false;//inconsistent 
             }
         }
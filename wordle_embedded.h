@@ -0,0 +1,37 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+// Dictionary compiled into the binary, so short runs skip reading and sorting the word list.
+// Build option:
+//   wordleEmbed 5 < words.txt > wordle_words.h
+//   g++ -std=c++17 -O2 -pthread -DWORDLE_EMBEDDED_DICT='"wordle_words.h"' wordleSolver.cpp -o wordleSolver
+// and run wordleSolver --embedded (input then has no dictionary block).
+// The generated header defines, in namespace wordle_embedded:
+//   kLength, kCount
+//   kPacked[kCount]            the words packed (IWordGame::packWord), sorted, no duplicates
+//   kLetterCounts[kCount][26]  how often each letter is in each word
+//   kOpeningRow[kCount]        pattern code of the opening guess kPacked[0] if word i is the secret
+#ifdef WORDLE_EMBEDDED_DICT
+#include WORDLE_EMBEDDED_DICT
+#else
+// built without the option: no words
+namespace wordle_embedded {
+constexpr int kLength = 0;
+constexpr int kCount = 0;
+constexpr uint64_t kPacked[1] = {0};
+constexpr unsigned char kLetterCounts[1][26] = {};
+constexpr uint32_t kOpeningRow[1] = {0};
+}
+#endif
+
+namespace wordle_embedded {
+constexpr bool kAvailable = kCount > 0;
+
+// the first guess of the lexicographic policy, kOpeningRow is its feedback row
+constexpr uint64_t openingGuess() { return kPacked[0]; }
+
+inline bool contains(uint64_t packed) {
+    return std::binary_search(kPacked, kPacked + kCount, packed);
+}
+}
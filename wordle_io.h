@@ -0,0 +1,107 @@
+#pragma once
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Fixed size queue between one producer thread and one consumer thread.
+// push blocks while full, pop blocks while empty, so memory never grows past capacity.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    // returns false if the queue was closed (item is dropped)
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // returns false once the queue is closed and everything was taken out
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return false;
+        out = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // no more pushes, wakes up everyone waiting
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_ = false;
+};
+
+// Text output that is collected into big chunks and written by a background thread.
+// Callers append to buffer() and call maybeFlush() every now and then.
+class OutputWriter {
+public:
+    explicit OutputWriter(std::FILE* file = stdout, size_t chunk_bytes = 1 << 16, size_t max_chunks = 8)
+        : file_(file), chunk_bytes_(chunk_bytes), chunks_(max_chunks)
+    {
+        buf_.reserve(chunk_bytes_ * 2);
+        thread_ = std::thread([this] { run(); });
+    }
+    ~OutputWriter() { finish(); }
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    std::string& buffer() { return buf_; }
+
+    // hand the chunk over once it is big enough
+    void maybeFlush() {
+        if (buf_.size() >= chunk_bytes_) flush();
+    }
+
+    void flush() {
+        if (buf_.empty()) return;
+        std::string full;
+        full.reserve(chunk_bytes_ * 2);
+        full.swap(buf_);
+        chunks_.push(std::move(full));
+    }
+
+    // write everything that is left and wait for the writer thread
+    void finish() {
+        if (!thread_.joinable()) return;
+        flush();
+        chunks_.close();
+        thread_.join();
+        std::fflush(file_);
+    }
+
+private:
+    void run() {
+        std::string chunk;
+        while (chunks_.pop(chunk)) {
+            std::fwrite(chunk.data(), 1, chunk.size(), file_);
+        }
+    }
+
+    std::FILE* file_;
+    size_t chunk_bytes_;
+    std::string buf_;
+    BoundedQueue<std::string> chunks_;
+    std::thread thread_;
+};
@@ -0,0 +1,158 @@
+#pragma once
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//totals over a batch of games.
+//Everything in here adds up, so the stats of several shards merge into the stats of the whole run
+struct BatchStats {
+    long long games = 0;
+    long long success = 0;
+    long long total_steps = 0;
+    int worst = 0;//most steps a won game needed
+    //steps_hist[s] = games won in s steps, index 0 counts lost games
+    std::vector<long long> steps_hist;
+    //sum of secretHash(index, secret) over the games played, so it does not depend on order
+    uint64_t checksum = 0;
+
+    //FNV-1a of the secret, mixed with its position in the input
+    static uint64_t secretHash(long long index, const std::string& secret) {
+        uint64_t h = 1469598103934665603ULL ^ ((uint64_t)index * 0x9E3779B97F4A7C15ULL);
+        for (char c : secret) {
+            h ^= (unsigned char)c;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    void record(int result) {
+        ++games;
+        int slot = 0;
+        if (result != -1) {
+            ++success;
+            total_steps += result;
+            slot = result;
+            if (result > worst) worst = result;
+        }
+        if ((int)steps_hist.size() <= slot) steps_hist.resize(slot + 1, 0);
+        ++steps_hist[slot];
+    }
+    void record(int result, long long index, const std::string& secret) {
+        record(result);
+        checksum += secretHash(index, secret);
+    }
+
+    void merge(const BatchStats& other) {
+        games += other.games;
+        success += other.success;
+        total_steps += other.total_steps;
+        if (other.worst > worst) worst = other.worst;
+        if (steps_hist.size() < other.steps_hist.size()) steps_hist.resize(other.steps_hist.size(), 0);
+        for (size_t s = 0; s < other.steps_hist.size(); ++s) steps_hist[s] += other.steps_hist[s];
+        checksum += other.checksum;
+    }
+
+    //SUMMARY success=<n>/<games> avg_steps=<x.xx>
+    std::string summaryLine() const {
+        double avg = (success > 0) ? (double)total_steps / success : 0.0;
+        std::ostringstream line;
+        line << "SUMMARY success=" << success << "/" << games
+             << " avg_steps=" << std::fixed << std::setprecision(2) << avg
+             << '\n';
+        return line.str();
+    }
+
+    //HISTOGRAM lost=<n> 1=<n> 2=<n> ...
+    std::string histogramLine() const {
+        std::ostringstream line;
+        line << "HISTOGRAM lost=" << (steps_hist.empty() ? 0 : steps_hist[0]);
+        for (size_t s = 1; s < steps_hist.size(); ++s) {
+            line << ' ' << s << '=' << steps_hist[s];
+        }
+        line << '\n';
+        return line.str();
+    }
+};
+
+//which games a process plays: game g (from 1) belongs to shard (g - 1) % count.
+//Round robin, so a shard does not need to know how many secrets there are
+struct ShardSpec {
+    long long index = 0;
+    long long count = 1;
+
+    bool owns(long long game) const { return (game - 1) % count == index; }
+
+    //"i/N" with 0 <= i < N
+    bool parse(const std::string& text) {
+        std::istringstream in(text);
+        char slash = 0;
+        long long i = -1, n = 0;
+        if (!(in >> i >> slash >> n) || slash != '/' || n < 1 || i < 0 || i >= n) return false;
+        index = i;
+        count = n;
+        return true;
+    }
+};
+
+//One line per shard that a merge turns back into the SUMMARY of the whole run:
+//PARTIAL shard=<i>/<N> games=<n> success=<n> steps=<n> worst=<n> hist=<lost>,<1>,<2>... checksum=<hex>
+inline std::string partialLine(const ShardSpec& shard, const BatchStats& stats) {
+    std::ostringstream line;
+    line << "PARTIAL shard=" << shard.index << '/' << shard.count
+         << " games=" << stats.games
+         << " success=" << stats.success
+         << " steps=" << stats.total_steps
+         << " worst=" << stats.worst
+         << " hist=";
+    if (stats.steps_hist.empty()) line << 0;
+    for (size_t s = 0; s < stats.steps_hist.size(); ++s) {
+        if (s > 0) line << ',';
+        line << stats.steps_hist[s];
+    }
+    line << " checksum=" << std::hex << std::setw(16) << std::setfill('0') << stats.checksum << '\n';
+    return line.str();
+}
+
+//reads a PARTIAL line back, false if it is not one
+inline bool parsePartialLine(const std::string& text, ShardSpec& shard, BatchStats& stats) {
+    std::istringstream in(text);
+    std::string word;
+    if (!(in >> word) || word != "PARTIAL") return false;
+    stats = BatchStats();
+    int fields = 0;
+    while (in >> word) {
+        size_t eq = word.find('=');
+        if (eq == std::string::npos) return false;
+        std::string key = word.substr(0, eq);
+        std::istringstream value(word.substr(eq + 1));
+        bool ok = true;
+        if (key == "shard") {
+            ok = shard.parse(value.str());
+        } else if (key == "games") {
+            ok = (bool)(value >> stats.games);
+        } else if (key == "success") {
+            ok = (bool)(value >> stats.success);
+        } else if (key == "steps") {
+            ok = (bool)(value >> stats.total_steps);
+        } else if (key == "worst") {
+            ok = (bool)(value >> stats.worst);
+        } else if (key == "hist") {
+            long long n;
+            char comma;
+            while (value >> n) {
+                stats.steps_hist.push_back(n);
+                if (!(value >> comma)) break;
+            }
+            ok = !stats.steps_hist.empty();
+        } else if (key == "checksum") {
+            ok = (bool)(value >> std::hex >> stats.checksum);
+        } else {
+            continue;//unknown keys are skipped, newer writers may add some
+        }
+        if (!ok) return false;
+        ++fields;
+    }
+    return fields == 7;
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "wordle_common.h"
+
+// Binary game traces, all numbers little endian.
+//   header: "WTRC", u8 version (2), u8 L, u32 T, u64 config hash (see configHash)
+//   game:   L bytes secret, u8 won, u16 turns, then per turn u64 packed guess + u32 pattern code
+// Version 1 traces (u16 T, u8 turns) are still read.
+// Recorded from real runs (--record) and played back with REPLAY to check that the engine and
+// solver still give the same games, and how fast.
+
+//FNV-1a over L, T and the sorted, de-duplicated dictionary (what the games actually use)
+inline uint64_t configHash(const Config& cfg) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](uint64_t v) {
+        for (int b = 0; b < 8; ++b) {
+            h ^= (v >> (8 * b)) & 0xFF;
+            h *= 1099511628211ULL;
+        }
+    };
+    mix((uint64_t)cfg.L);
+    mix((uint64_t)cfg.T);
+    std::vector<uint64_t> words;
+    for (const auto& w : cfg.dict_words) {
+        uint64_t packed = IWordGame::packWord(w, cfg.L);
+        if (packed != IWordGame::kInvalidWord) words.push_back(packed);
+    }
+    if (cfg.packed_words) words = *cfg.packed_words;
+    if (cfg.embedded) words.assign(wordle_embedded::kPacked, wordle_embedded::kPacked + wordle_embedded::kCount);
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    for (uint64_t w : words) mix(w);
+    return h;
+}
+
+//one game read back from a trace
+struct TraceGame {
+    std::string secret;
+    bool won = false;
+    std::vector<PackedTurn> turns;
+};
+
+static constexpr int kTraceVersion = 2;
+
+class TraceWriter {
+public:
+    TraceWriter(std::FILE* file, const Config& cfg) : file_(file), L_(cfg.L) {
+        buf_ += "WTRC";
+        put(kTraceVersion, 1);
+        put((uint64_t)cfg.L, 1);
+        put((uint64_t)cfg.T, 4);
+        put(configHash(cfg), 8);
+    }
+    ~TraceWriter() {
+        flush();
+        std::fclose(file_);
+    }
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    //turns: any list of PackedTurn (a game's TurnList or a FinishedGame's)
+    template <typename Turns>
+    void add(const std::string& secret, bool won, const Turns& turns) {
+        buf_.append(secret, 0, L_);
+        put(won ? 1 : 0, 1);
+        put(turns.size(), 2);
+        for (const auto& turn : turns) {
+            put(turn.guess, 8);
+            put((uint64_t)turn.pattern, 4);
+        }
+        if (buf_.size() >= (1 << 16)) flush();
+    }
+
+    void flush() {
+        std::fwrite(buf_.data(), 1, buf_.size(), file_);
+        buf_.clear();
+    }
+
+private:
+    void put(uint64_t v, int bytes) {
+        for (int b = 0; b < bytes; ++b) buf_ += (char)((v >> (8 * b)) & 0xFF);
+    }
+
+    std::FILE* file_;
+    int L_;
+    std::string buf_;
+};
+
+class TraceReader {
+public:
+    //check ok() before reading, a file that is not a trace is not ok
+    explicit TraceReader(std::FILE* file) : file_(file) {
+        char magic[4];
+        ok_ = file_ && std::fread(magic, 1, 4, file_) == 4 && std::string(magic, 4) == "WTRC";
+        if (ok_) {
+            version_ = (int)get(1);
+            ok_ = version_ == 1 || version_ == kTraceVersion;
+        }
+        if (ok_) {
+            L_ = (int)get(1);
+            T_ = (int)get(version_ == 1 ? 2 : 4);
+            hash_ = get(8);
+            ok_ = !eof_ && L_ >= 1 && L_ <= IWordGame::kMaxPackedLength;
+        }
+    }
+    ~TraceReader() {
+        if (file_) std::fclose(file_);
+    }
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    bool ok() const { return ok_; }
+    int length() const { return L_; }
+    int tries() const { return T_; }
+    uint64_t hash() const { return hash_; }
+    //the trace stopped in the middle of a game (or could not be read), it did not just end
+    bool truncated() const { return truncated_; }
+
+    //false at the end of the trace. Ending right after a game is a clean end, anything
+    //else sets truncated()
+    bool next(TraceGame& game) {
+        game.secret.resize(L_);
+        size_t got = std::fread(&game.secret[0], 1, L_, file_);
+        if (got != (size_t)L_) {
+            truncated_ = got > 0 || std::ferror(file_);
+            return false;
+        }
+        game.won = get(1) != 0;
+        int turns = (int)get(version_ == 1 ? 1 : 2);
+        game.turns.resize(turns);
+        for (auto& turn : game.turns) {
+            turn.guess = get(8);
+            turn.pattern = (int)get(4);
+        }
+        if (eof_) truncated_ = true;
+        return !eof_;
+    }
+
+private:
+    uint64_t get(int bytes) {
+        unsigned char b[8];
+        if (std::fread(b, 1, bytes, file_) != (size_t)bytes) {
+            eof_ = true;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = bytes - 1; i >= 0; --i) v = (v << 8) | b[i];
+        return v;
+    }
+
+    std::FILE* file_;
+    bool ok_ = false;
+    bool eof_ = false;
+    bool truncated_ = false;
+    int version_ = 0;
+    int L_ = 0;
+    int T_ = 0;
+    uint64_t hash_ = 0;
+};